@@ -65,6 +65,64 @@ void psMain(in V2P pixel, out P2F result)
         D3D11_INPUT_ELEMENT_DESC{"WORLDMATRIX", 3, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_INSTANCE_DATA, 1},
     };
 
+    void TransformVertices(const Matrix4x4& matrix, PositionColoredTextured vertices[], size_t count) noexcept
+    {
+        return TransformVertices(matrix, vertices, vertices, count);
+    }
+
+    void TransformVertices(const Matrix4x4& matrix, const PositionColoredTextured src[], PositionColoredTextured dst[], size_t count) noexcept
+    {
+        if (src != dst) std::copy_n(src, count, dst);
+        if (count) transform_points(matrix, &src[0].Position, sizeof(PositionColoredTextured), &dst[0].Position, sizeof(PositionColoredTextured), count);
+    }
+
+    void TransformVertices(const Matrix4x4& matrix, const PositionColoredTextured src[], Span<PositionColoredTextured> dst) noexcept
+    {
+        // Mapped memory may be write-combined: never read it back; transform in chunks on the stack and write whole vertices.
+        constexpr size_t chunk = 64;
+        PositionVector positions[chunk];
+        for (size_t i = 0; i < dst.size(); i += chunk)
+        {
+            size_t n = std::min(chunk, dst.size() - i);
+            transform_points(matrix, &src[i].Position, sizeof(PositionColoredTextured), positions, sizeof(PositionVector), n);
+            for (size_t j = 0; j < n; j++)
+                dst.data()[i + j] = PositionColoredTextured{positions[j], src[i + j].Color0, src[i + j].Color1, src[i + j].Texture};
+        }
+    }
+
+    void MakeWorldMatrices(const Matrix4x4 world[], WorldMatrix dst[], size_t count) noexcept
+    {
+        return transpose(world, &dst[0].World, count);
+    }
+
+    void MakeWorldMatrices(const Matrix4x4 world[], const Matrix4x4& post, WorldMatrix dst[], size_t count) noexcept
+    {
+        return multiply_transpose(world, post, &dst[0].World, count);
+    }
+
+    void MakeWorldMatrices(const Affine2D world[], WorldMatrix dst[], size_t count) noexcept
+    {
+        using arkxmm::shuffle;
+        const auto z = arkxmm::f32x4(0.0f, 0.0f, 1.0f, 0.0f);
+        const auto w = arkxmm::f32x4(0.0f, 0.0f, 0.0f, 1.0f);
+        for (size_t i = 0; i < count; i++)
+        {
+            auto l = shuffle<0, 2, 1, 3>(world[i].linear());      // {m00, m10, m01, m11}
+            auto t = shuffle<2, 0, 2, 1>(world[i].translation()); // {0, m20, 0, m21}
+            dst[i].World = Matrix4x4{shuffle<0, 1, 0, 1>(l, t), shuffle<2, 3, 2, 3>(l, t), z, w};
+        }
+    }
+
+    void MultiplyWorldMatrices(WorldMatrix instances[], const Matrix4x4& post, size_t count) noexcept
+    {
+        return multiply(&instances[0].World, post, &instances[0].World, count);
+    }
+
+    void TransposeWorldMatrices(WorldMatrix instances[], size_t count) noexcept
+    {
+        return transpose(&instances[0].World, &instances[0].World, count);
+    }
+
     BasicPrimitiveBatch::BasicPrimitiveBatch(ID3D11Device* device)
         : factory_(device)
         , vertex_shader_code_(factory_.CompileShader(shader_source_code_, "BasicEffect.hlsl", "vsMain", "vs_4_0", nullptr, 0))
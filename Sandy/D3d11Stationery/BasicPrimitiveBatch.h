@@ -14,6 +14,7 @@
 #include "CommonStateObjects.h"
 
 #include "../misc/Math.h"
+#include "../misc/TransformHierarchy.h"
 
 namespace sandy::d3d11
 {
@@ -48,6 +49,22 @@ namespace sandy::d3d11
     static_assert(std::is_trivially_copyable_v<WorldMatrix> && sizeof(WorldMatrix) == 64);
     static_assert(std::is_trivially_copyable_v<ViewProjectionMatrix> && sizeof(ViewProjectionMatrix) == 64);
 
+    // Pre-transforms vertex positions (e.g. static geometry, CPU skinning).
+    void TransformVertices(const Matrix4x4& matrix, PositionColoredTextured vertices[], size_t count) noexcept;
+    void TransformVertices(const Matrix4x4& matrix, const PositionColoredTextured src[], PositionColoredTextured dst[], size_t count) noexcept;
+    void TransformVertices(const Matrix4x4& matrix, const PositionColoredTextured src[], Span<PositionColoredTextured> dst) noexcept; // dst: mapped buffer, write only
+
+    // WORLDMATRIX instance stream is consumed as mul(worldTransform, pos), i.e. transposed row-vector matrix.
+    void MakeWorldMatrices(const Matrix4x4 world[], WorldMatrix dst[], size_t count) noexcept;                         // dst[i] = transpose(world[i])
+    void MakeWorldMatrices(const Matrix4x4 world[], const Matrix4x4& post, WorldMatrix dst[], size_t count) noexcept; // dst[i] = transpose(world[i] * post)
+    void MakeWorldMatrices(const Affine2D world[], WorldMatrix dst[], size_t count) noexcept;                          // dst[i] = transpose(to_matrix4x4(world[i]))
+    void MultiplyWorldMatrices(WorldMatrix instances[], const Matrix4x4& post, size_t count) noexcept;                 // in place: World = World * post
+    void TransposeWorldMatrices(WorldMatrix instances[], size_t count) noexcept;                                      // in place: World = transpose(World)
+
+    // TransformHierarchy keeps its instance stream (transpose(world)) contiguous: pass hierarchy.size() instances, or the updated range for partial uploads.
+    static_assert(alignof(WorldMatrix) == alignof(Matrix4x4) && sizeof(WorldMatrix) == sizeof(Matrix4x4));
+    inline const WorldMatrix* WorldMatrices(const TransformHierarchy& hierarchy) noexcept { return reinterpret_cast<const WorldMatrix*>(hierarchy.instance_matrices()); }
+
     class BasicPrimitiveBatch
     {
     public:
@@ -37,6 +37,8 @@
 
 #include <xtw/debug.h>
 
+#include "../misc/ImageOps.h"
+
 #define GDIP_THROW_ON_FAILURE (::xtw::debug::percent_operator_redirection([](::Gdiplus::Status r) { if (r != ::Gdiplus::Status::Ok) throw ::std::runtime_error("gdiplus error: " + ::std::to_string((int)r)); }))%
 
 namespace sandy::gdip
@@ -541,6 +543,20 @@ namespace sandy::gdip
         src_rect.Height = std::clamp(src_rect.Height, 0, dst_clip.Y + dst_clip.Height - dst_pos.Y);
     }
 
+    template <class T>
+    static Span2d<T> LockedSpan(const Gdiplus::BitmapData& locked, const Gdiplus::Rect& rect)
+    {
+        const auto base = static_cast<const std::byte*>(locked.Scan0) + static_cast<size_t>(rect.Y) * locked.Stride + static_cast<size_t>(rect.X) * sizeof(T);
+        return Span2d<T>{base, static_cast<size_t>(rect.Width), static_cast<size_t>(rect.Height), static_cast<size_t>(locked.Stride)};
+    }
+
+    template <class T>
+    static Span2d<T> DestinationSpan(void* bitmap, size_t pitch, const Gdiplus::Point& pos, size_t width, size_t height)
+    {
+        const auto base = static_cast<std::byte*>(bitmap) + static_cast<size_t>(pos.Y) * pitch + static_cast<size_t>(pos.X) * sizeof(T);
+        return Span2d<T>{base, width, height, pitch};
+    }
+
     void BitBlt32bppArgb(
         GdipBitmap* src_bitmap_,
         const RECT& src_rect_,
@@ -562,24 +578,9 @@ namespace sandy::gdip
         GDIP_THROW_ON_FAILURE src_bitmap->LockBits(&whole, Gdiplus::ImageLockMode::ImageLockModeRead, PixelFormat32bppARGB, &locked);
 
         {
-            const auto pSrc = static_cast<const uint32_t*>(locked.Scan0);
-            const auto pDst = static_cast<uint32_t*>(dst_bitmap);
-            const auto srcX = src_rect.X;
-            const auto srcY = src_rect.Y;
-            const auto srcP = static_cast<size_t>(locked.Stride / 4);
-            const auto dstX = dst_pos.X;
-            const auto dstY = dst_pos.Y;
-            const auto dstP = static_cast<size_t>(dst_pitch / 4);
-            const auto cpyW = src_rect.Width;
-            const auto cpyH = src_rect.Height;
-
-            for (auto y = 0; y < cpyH; y++)
-            {
-                const auto dst_base = pDst + (dstY + y) * dstP + dstX;
-                const auto src_base = pSrc + (srcY + y) * srcP + srcX;
-                for (auto x = 0; x < cpyW; x++)
-                    dst_base[x] = src_base[x] | 0x00FFFFFFu;
-            }
+            const auto src = LockedSpan<const uint32_t>(locked, src_rect);
+            const auto dst = DestinationSpan<uint32_t>(dst_bitmap, dst_pitch, dst_pos, src.width, src.height);
+            expand_alpha(src, dst, 0x00FFFFFF); // white, keeping the glyph alpha
         }
 
         GDIP_THROW_ON_FAILURE src_bitmap->UnlockBits(&locked);
@@ -606,24 +607,9 @@ namespace sandy::gdip
         GDIP_THROW_ON_FAILURE src_bitmap->LockBits(&whole, Gdiplus::ImageLockMode::ImageLockModeRead, PixelFormat32bppARGB, &locked);
 
         {
-            const auto pSrc = static_cast<const uint32_t*>(locked.Scan0);
-            const auto pDst = static_cast<uint8_t*>(dst_bitmap);
-            const auto srcX = src_rect.X;
-            const auto srcY = src_rect.Y;
-            const auto srcP = static_cast<size_t>(locked.Stride / 4);
-            const auto dstX = dst_pos.X;
-            const auto dstY = dst_pos.Y;
-            const auto dstP = static_cast<size_t>(dst_pitch);
-            const auto cpyW = src_rect.Width;
-            const auto cpyH = src_rect.Height;
-
-            for (auto y = 0; y < cpyH; y++)
-            {
-                const auto dst_base = pDst + (dstY + y) * dstP + dstX;
-                const auto src_base = pSrc + (srcY + y) * srcP + srcX;
-                for (auto x = 0; x < cpyW; x++)
-                    dst_base[x] = static_cast<uint8_t>(src_base[x] >> 24);
-            }
+            const auto src = LockedSpan<const uint32_t>(locked, src_rect);
+            const auto dst = DestinationSpan<uint8_t>(dst_bitmap, dst_pitch, dst_pos, src.width, src.height);
+            extract_alpha(src, dst);
         }
 
         GDIP_THROW_ON_FAILURE src_bitmap->UnlockBits(&locked);
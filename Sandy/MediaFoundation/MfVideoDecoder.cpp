@@ -10,17 +10,22 @@
 #include <mfreadwrite.h>
 #include <propvarutil.h>
 
+#include <algorithm>
 #include <memory>
+#include <atomic>
 #include <chrono>
 #include <tuple>
 #include <optional>
 #include <utility>
 #include <thread>
 #include <mutex>
+#include <stdexcept>
 
 #include <xtw/debug.h>
 
-#include "../misc/ConcurrentQueue.h"
+#include "../misc/Mailbox.h"
+#include "../misc/PresentationQueue.h"
+#include "../misc/SpscQueue.h"
 
 namespace sandy::mf
 {
@@ -73,6 +78,21 @@ namespace sandy::mf
             return {duration, hr};
         }
 
+        /// True if the media source reports MFMEDIASOURCE_IS_LIVE (cameras, capture): it delivers samples in real time.
+        [[nodiscard]] bool IsLive() const
+        {
+            if (!IsReady()) return false;
+
+            PROPVARIANT var{};
+            if (FAILED(reader_->GetPresentationAttribute(static_cast<DWORD>(MF_SOURCE_READER_MEDIASOURCE), MF_SOURCE_READER_MEDIASOURCE_CHARACTERISTICS, &var))) return false;
+
+            ULONG characteristics{};
+            HRESULT hr = PropVariantToUInt32(var, &characteristics);
+            PropVariantClear(&var);
+
+            return SUCCEEDED(hr) && (characteristics & MFMEDIASOURCE_IS_LIVE);
+        }
+
         std::tuple<xtw::com_ptr<IMFMediaType>, HRESULT> GetNativeMediaType(_In_ DWORD stream_index, _In_ DWORD media_type_index = 0)
         {
             if (!IsReady()) return {nullptr, XTW_EXPECT_SUCCESS E_UNEXPECTED};
@@ -145,25 +165,44 @@ namespace sandy::mf
 
     class MfVideoDecoder::Impl final
     {
+    public:
+        enum struct Handoff
+        {
+            Fifo,         // decoded_frames_
+            Latest,       // latest_frame_
+            Presentation, // presented_frames_
+        };
+
+    private:
         std::recursive_mutex mutex_{};
         std::unique_ptr<MfSourceReader> source_reader_{};
+        Handoff handoff_{};
         size_t decoder_queue_depth_{};
+        size_t decoder_queue_bytes_{}; // 0: limit by count only
+        LONGLONG max_lateness_{};
         DWORD stream_index_{};
 
         bool ready_{};
         xtw::com_ptr<IMFVideoMediaType> video_media_type_{};
         MFVideoInfo video_format_{};
         LONGLONG video_duration_{};
+        bool live_source_{};
 
         std::thread worker_thread_{};
         std::atomic_flag running_{};
-        std::optional<ConcurrentQueue<MfVideoFrameSample>> decoded_frames_{};
+        std::optional<SpscQueue<MfVideoFrameSample>> decoded_frames_{};
         MfVideoFrameSample next_frame_{};
+        std::optional<Mailbox<MfVideoFrameSample>> latest_frame_{};
+        std::atomic<bool> decoding_{}; // worker still publishing to latest_frame_
+        std::optional<PresentationQueue<MfVideoFrameSample, LONGLONG>> presented_frames_{};
 
     public:
-        Impl(std::unique_ptr<MfSourceReader> source, size_t queue_depth, DWORD stream_index)
+        Impl(std::unique_ptr<MfSourceReader> source, Handoff handoff, size_t queue_depth, size_t queue_bytes, LONGLONG max_lateness, DWORD stream_index)
             : source_reader_(std::move(source))
+            , handoff_(handoff)
             , decoder_queue_depth_(queue_depth)
+            , decoder_queue_bytes_(queue_bytes)
+            , max_lateness_(max_lateness)
             , stream_index_(stream_index)
         {
             ready_ = source_reader_->IsReady();
@@ -204,6 +243,8 @@ namespace sandy::mf
                 this->video_duration_ = duration;
                 ready_ &= SUCCEEDED(hr);
             }
+
+            if (ready_) live_source_ = source_reader_->IsLive();
         }
 
         Impl(const Impl& other) = delete;
@@ -216,10 +257,13 @@ namespace sandy::mf
             if (worker_thread_.joinable())
             {
                 running_.clear();
-                while (decoded_frames_ && decoded_frames_->pop_wait()) {}
+                if (decoded_frames_) decoded_frames_->drain();
+                if (presented_frames_) presented_frames_->close();
                 worker_thread_.join();
                 next_frame_ = {};
                 decoded_frames_.reset();
+                latest_frame_.reset();
+                presented_frames_.reset();
             }
         }
 
@@ -231,9 +275,24 @@ namespace sandy::mf
         bool IsEndOfStream()
         {
             std::lock_guard lock(mutex_);
+            if (latest_frame_) return !decoding_.load(std::memory_order_acquire) && !latest_frame_->fresh();
+            if (presented_frames_) return presented_frames_->closed();
             return !decoded_frames_ || decoded_frames_->closed();
         }
 
+        QueueStatistics GetQueueStatistics()
+        {
+            std::lock_guard lock(mutex_);
+            if (presented_frames_) return presented_frames_->statistics();
+            return decoded_frames_ ? decoded_frames_->statistics() : QueueStatistics{};
+        }
+
+        PresentationStatistics<LONGLONG> GetPresentationStatistics()
+        {
+            std::lock_guard lock(mutex_);
+            return presented_frames_ ? presented_frames_->presentation_statistics() : PresentationStatistics<LONGLONG>{};
+        }
+
         void Rewind(bool looping)
         {
             if (!IsReady()) return;
@@ -242,32 +301,68 @@ namespace sandy::mf
             if (worker_thread_.joinable())
             {
                 running_.clear();
-                while (decoded_frames_ && decoded_frames_->pop_wait()) {}
+                if (decoded_frames_) decoded_frames_->drain();
+                if (presented_frames_) presented_frames_->close();
                 worker_thread_.join();
                 next_frame_ = {};
                 decoded_frames_.reset();
+                latest_frame_.reset();
+                presented_frames_.reset();
             }
 
             XTW_EXPECT_SUCCESS source_reader_->Seek(0);
 
             {
                 running_.test_and_set();
-                decoded_frames_.emplace(decoder_queue_depth_);
+                if (handoff_ == Handoff::Latest)
+                {
+                    latest_frame_.emplace();
+                    decoding_.store(true, std::memory_order_relaxed);
+                }
+                else if (handoff_ == Handoff::Presentation)
+                    presented_frames_.emplace(decoder_queue_depth_, [](const MfVideoFrameSample& frame) { return frame.Time(); }, max_lateness_);
+                else if (decoder_queue_bytes_)
+                    decoded_frames_.emplace(decoder_queue_bytes_, [](const MfVideoFrameSample& frame) -> size_t
+                    {
+                        DWORD length{};
+                        return SUCCEEDED(frame.Sample()->GetTotalLength(&length)) ? length : 0;
+                    }, decoder_queue_depth_);
+                else
+                    decoded_frames_.emplace(decoder_queue_depth_);
                 worker_thread_ = std::thread([this, looping]
                 {
                     CoInitializeEx(nullptr, COINIT_MULTITHREADED | COINIT_DISABLE_OLE1DDE | COINIT_SPEED_OVER_MEMORY);
 
                     DWORD loop_count = 0;
 
-                    xtw::com_ptr<IMFVideoMediaType> frame_media_type_;
-                    while (running_.test_and_set())
+                    // Latest from a non-live source: a file decodes far faster than real time, so hold each frame back until
+                    // its sample time on a steady clock started at the first frame. Live sources already deliver in real time.
+                    // A frame more than a second ahead (a timestamp discontinuity) restarts the clock instead of stalling.
+                    // The wait goes in 10ms slices checking running_, so ~Impl and Rewind are not held up by it. Returns false once stopped.
+                    using sample_duration = std::chrono::duration<LONGLONG, std::ratio<1, 10'000'000>>;
+                    std::optional<std::pair<std::chrono::steady_clock::time_point, LONGLONG>> pace_origin{};
+                    auto pace = [this, &pace_origin](LONGLONG sample_time)
                     {
-                        if (decoded_frames_->size() == decoded_frames_->capacity())
+                        const auto now = std::chrono::steady_clock::now();
+                        if (!pace_origin) pace_origin.emplace(now, sample_time);
+                        const auto due = pace_origin->first + std::chrono::duration_cast<std::chrono::steady_clock::duration>(sample_duration(sample_time - pace_origin->second));
+                        if (due - now > std::chrono::seconds(1))
                         {
-                            std::this_thread::sleep_for(std::chrono::milliseconds(1));
-                            continue;
+                            pace_origin.emplace(now, sample_time);
+                            return true;
                         }
 
+                        for (auto t = now; t < due; t = std::chrono::steady_clock::now())
+                        {
+                            if (!running_.test_and_set()) return false;
+                            std::this_thread::sleep_until(std::min(due, t + std::chrono::milliseconds(10)));
+                        }
+                        return true;
+                    };
+
+                    xtw::com_ptr<IMFVideoMediaType> frame_media_type_;
+                    while (running_.test_and_set())
+                    {
                         DWORD flags{};
                         auto [sample, hr] = source_reader_->ReadSample(stream_index_, 0, nullptr, &flags, nullptr);
                         XTW_EXPECT_SUCCESS hr;
@@ -298,18 +393,31 @@ namespace sandy::mf
                         if (sample)
                         {
                             sample.Sample()->SetSampleTime(sample.Time() + video_duration_ * loop_count);
-                            decoded_frames_->emplace(MfVideoFrameSample(sample.Sample(), frame_media_type_));
+                            if (latest_frame_)
+                            {
+                                if (!live_source_ && !pace(sample.Time())) break; // stopped while waiting
+                                latest_frame_->publish(MfVideoFrameSample(sample.Sample(), frame_media_type_));
+                            }
+                            else if (presented_frames_)
+                                presented_frames_->emplace(MfVideoFrameSample(sample.Sample(), frame_media_type_));
+                            else
+                                decoded_frames_->emplace(MfVideoFrameSample(sample.Sample(), frame_media_type_));
                         }
                     }
 
-                    decoded_frames_->close();
+                    if (latest_frame_)
+                        decoding_.store(false, std::memory_order_release);
+                    else if (presented_frames_)
+                        presented_frames_->close();
+                    else
+                        decoded_frames_->close();
                     CoUninitialize();
                 });
             }
 
             // Wait for first frame decoded
             for (auto timeout = std::chrono::high_resolution_clock::now() + std::chrono::milliseconds(5000);
-                 std::chrono::high_resolution_clock::now() < timeout && decoded_frames_->empty();
+                 std::chrono::high_resolution_clock::now() < timeout && (latest_frame_ ? !latest_frame_->fresh() : presented_frames_ ? presented_frames_->empty() : decoded_frames_->empty());
                  std::this_thread::yield())
                 continue;
         }
@@ -319,6 +427,18 @@ namespace sandy::mf
             if (!IsReady()) return nullptr;
             std::lock_guard lock(mutex_);
 
+            if (latest_frame_)
+            {
+                auto frame = latest_frame_->take();
+                return frame ? std::move(*frame) : MfVideoFrameSample{};
+            }
+
+            if (presented_frames_)
+            {
+                auto frame = presented_frames_->fetch(current_time);
+                return frame ? std::move(*frame) : MfVideoFrameSample{};
+            }
+
             // Find sample_ for the current time.
             MfVideoFrameSample current_frame{};
             while (decoded_frames_ && !decoded_frames_->closed())
@@ -343,15 +463,33 @@ namespace sandy::mf
         }
     };
 
-    MfVideoDecoder::MfVideoDecoder(IMFByteStream* stream, int decoder_queue_depth, DWORD stream_index) : impl_(std::make_unique<Impl>(std::make_unique<MfSourceReader>(stream, nullptr), decoder_queue_depth, stream_index)) {}
-    MfVideoDecoder::MfVideoDecoder(IMFByteStream* stream, IMFAttributes* attributes, int decoder_queue_depth, DWORD stream_index) : impl_(std::make_unique<Impl>(std::make_unique<MfSourceReader>(stream, attributes), decoder_queue_depth, stream_index)) {}
-    MfVideoDecoder::MfVideoDecoder(IMFSourceReader* source, int decoder_queue_depth, DWORD stream_index) : impl_(std::make_unique<Impl>(std::make_unique<MfSourceReader>(source), decoder_queue_depth, stream_index)) {}
+    // a zero budget would silently make a count-only queue.
+    static size_t QueueBytes(const MfVideoDecoder::QueueByteBudget& budget)
+    {
+        if (budget.bytes == 0) throw std::invalid_argument("budget.bytes must not be zero");
+        return budget.bytes;
+    }
+
+    MfVideoDecoder::MfVideoDecoder(IMFByteStream* stream, int decoder_queue_depth, DWORD stream_index) : impl_(std::make_unique<Impl>(std::make_unique<MfSourceReader>(stream, nullptr), Impl::Handoff::Fifo, decoder_queue_depth, 0, 0, stream_index)) {}
+    MfVideoDecoder::MfVideoDecoder(IMFByteStream* stream, IMFAttributes* attributes, int decoder_queue_depth, DWORD stream_index) : impl_(std::make_unique<Impl>(std::make_unique<MfSourceReader>(stream, attributes), Impl::Handoff::Fifo, decoder_queue_depth, 0, 0, stream_index)) {}
+    MfVideoDecoder::MfVideoDecoder(IMFSourceReader* source, int decoder_queue_depth, DWORD stream_index) : impl_(std::make_unique<Impl>(std::make_unique<MfSourceReader>(source), Impl::Handoff::Fifo, decoder_queue_depth, 0, 0, stream_index)) {}
+    MfVideoDecoder::MfVideoDecoder(IMFByteStream* stream, QueueByteBudget budget, DWORD stream_index) : impl_(std::make_unique<Impl>(std::make_unique<MfSourceReader>(stream, nullptr), Impl::Handoff::Fifo, budget.max_frames, QueueBytes(budget), 0, stream_index)) {}
+    MfVideoDecoder::MfVideoDecoder(IMFByteStream* stream, IMFAttributes* attributes, QueueByteBudget budget, DWORD stream_index) : impl_(std::make_unique<Impl>(std::make_unique<MfSourceReader>(stream, attributes), Impl::Handoff::Fifo, budget.max_frames, QueueBytes(budget), 0, stream_index)) {}
+    MfVideoDecoder::MfVideoDecoder(IMFSourceReader* source, QueueByteBudget budget, DWORD stream_index) : impl_(std::make_unique<Impl>(std::make_unique<MfSourceReader>(source), Impl::Handoff::Fifo, budget.max_frames, QueueBytes(budget), 0, stream_index)) {}
+    MfVideoDecoder::MfVideoDecoder(IMFByteStream* stream, LowLatency, DWORD stream_index) : impl_(std::make_unique<Impl>(std::make_unique<MfSourceReader>(stream, nullptr), Impl::Handoff::Latest, 0, 0, 0, stream_index)) {}
+    MfVideoDecoder::MfVideoDecoder(IMFByteStream* stream, IMFAttributes* attributes, LowLatency, DWORD stream_index) : impl_(std::make_unique<Impl>(std::make_unique<MfSourceReader>(stream, attributes), Impl::Handoff::Latest, 0, 0, 0, stream_index)) {}
+    MfVideoDecoder::MfVideoDecoder(IMFSourceReader* source, LowLatency, DWORD stream_index) : impl_(std::make_unique<Impl>(std::make_unique<MfSourceReader>(source), Impl::Handoff::Latest, 0, 0, 0, stream_index)) {}
+    MfVideoDecoder::MfVideoDecoder(IMFByteStream* stream, PresentationDeadline deadline, DWORD stream_index) : impl_(std::make_unique<Impl>(std::make_unique<MfSourceReader>(stream, nullptr), Impl::Handoff::Presentation, deadline.queue_depth, 0, deadline.max_lateness, stream_index)) {}
+    MfVideoDecoder::MfVideoDecoder(IMFByteStream* stream, IMFAttributes* attributes, PresentationDeadline deadline, DWORD stream_index) : impl_(std::make_unique<Impl>(std::make_unique<MfSourceReader>(stream, attributes), Impl::Handoff::Presentation, deadline.queue_depth, 0, deadline.max_lateness, stream_index)) {}
+    MfVideoDecoder::MfVideoDecoder(IMFSourceReader* source, PresentationDeadline deadline, DWORD stream_index) : impl_(std::make_unique<Impl>(std::make_unique<MfSourceReader>(source), Impl::Handoff::Presentation, deadline.queue_depth, 0, deadline.max_lateness, stream_index)) {}
     MfVideoDecoder::~MfVideoDecoder() = default;
     bool MfVideoDecoder::IsReady() const { return impl_->IsReady(); }
     xtw::com_ptr<IMFVideoMediaType> MfVideoDecoder::GetMediaType() const { return impl_->GetMediaType(); }
     const MFVideoInfo& MfVideoDecoder::GetVideoInfo() const { return impl_->GetVideoInfo(); }
     LONGLONG MfVideoDecoder::GetVideoDuration() const { return impl_->GetVideoDuration(); }
     bool MfVideoDecoder::IsEndOfStream() const { return impl_->IsEndOfStream(); }
+    QueueStatistics MfVideoDecoder::GetQueueStatistics() const { return impl_->GetQueueStatistics(); }
+    PresentationStatistics<LONGLONG> MfVideoDecoder::GetPresentationStatistics() const { return impl_->GetPresentationStatistics(); }
     void MfVideoDecoder::Rewind(bool looping) { return impl_->Rewind(looping); }
     MfVideoFrameSample MfVideoDecoder::FetchFrame(LONGLONG current_time) { return impl_->FetchFrame(current_time); }
 }
@@ -16,6 +16,8 @@
 #include <xtw/com.h>
 
 #include "MfVideoFrameSample.h"
+#include "../misc/QueueStatistics.h"
+#include "../misc/PresentationQueue.h"
 
 namespace sandy::mf
 {
@@ -27,9 +29,43 @@ namespace sandy::mf
     public:
         static constexpr DWORD kFirstVideoStreamIndex = static_cast<DWORD>(MF_SOURCE_READER_FIRST_VIDEO_STREAM);
 
+        /// Limits decoded frames queued ahead by their buffer size (IMFSample::GetTotalLength) as well as their count,
+        /// e.g. 32 MiB holds about 10 1080p NV12 frames but only 2 or 3 at 4K. bytes == 0 throws std::invalid_argument.
+        struct QueueByteBudget
+        {
+            size_t bytes = size_t{32} << 20;
+            int max_frames = 10;
+        };
+
+        /// Hands each decoded frame over through a Mailbox instead of a queue, for live sources (cameras, screen capture).
+        /// The decoder never waits for playback: FetchFrame returns the newest frame not fetched yet, older ones are dropped.
+        /// A non-live source (a file) is paced instead: each frame is published at its sample time, so it plays at its own rate.
+        struct LowLatency
+        {
+        };
+
+        /// Queues decoded frames by presentation time for playback that may fall behind the clock FetchFrame is given.
+        /// Frames more than max_lateness (100ns units) behind it are dropped by the decoder instead of queued,
+        /// and FetchFrame skips straight to the newest due frame. See GetPresentationStatistics.
+        /// A decoder that stays further behind than max_lateness shows no new frames, so keep it above its worst stall.
+        struct PresentationDeadline
+        {
+            LONGLONG max_lateness = 5'000'000; // 500ms
+            int queue_depth = 10;
+        };
+
         MfVideoDecoder(IMFByteStream* stream, int decoder_queue_depth = 10, DWORD stream_index = kFirstVideoStreamIndex);
         MfVideoDecoder(IMFByteStream* stream, IMFAttributes* attributes, int decoder_queue_depth = 10, DWORD stream_index = kFirstVideoStreamIndex);
         MfVideoDecoder(IMFSourceReader* source, int decoder_queue_depth = 10, DWORD stream_index = kFirstVideoStreamIndex);
+        MfVideoDecoder(IMFByteStream* stream, QueueByteBudget budget, DWORD stream_index = kFirstVideoStreamIndex);
+        MfVideoDecoder(IMFByteStream* stream, IMFAttributes* attributes, QueueByteBudget budget, DWORD stream_index = kFirstVideoStreamIndex);
+        MfVideoDecoder(IMFSourceReader* source, QueueByteBudget budget, DWORD stream_index = kFirstVideoStreamIndex);
+        MfVideoDecoder(IMFByteStream* stream, LowLatency, DWORD stream_index = kFirstVideoStreamIndex);
+        MfVideoDecoder(IMFByteStream* stream, IMFAttributes* attributes, LowLatency, DWORD stream_index = kFirstVideoStreamIndex);
+        MfVideoDecoder(IMFSourceReader* source, LowLatency, DWORD stream_index = kFirstVideoStreamIndex);
+        MfVideoDecoder(IMFByteStream* stream, PresentationDeadline deadline, DWORD stream_index = kFirstVideoStreamIndex);
+        MfVideoDecoder(IMFByteStream* stream, IMFAttributes* attributes, PresentationDeadline deadline, DWORD stream_index = kFirstVideoStreamIndex);
+        MfVideoDecoder(IMFSourceReader* source, PresentationDeadline deadline, DWORD stream_index = kFirstVideoStreamIndex);
         MfVideoDecoder(const MfVideoDecoder& other) = delete;
         MfVideoDecoder(MfVideoDecoder&& other) noexcept = delete;
         MfVideoDecoder& operator=(const MfVideoDecoder& other) = delete;
@@ -43,7 +79,18 @@ namespace sandy::mf
         [[nodiscard]] LONGLONG GetVideoDuration() const;
 
         [[nodiscard]] bool IsEndOfStream() const;
+
+        /// Decoded-frame queue counters since the last Rewind (zero unless SANDY_QUEUE_STATISTICS is enabled).
+        /// Producer wait time is the decoder running ahead of playback; empty pops are FetchFrame finding no decoded frame.
+        /// Always empty in LowLatency mode, which has no queue.
+        [[nodiscard]] QueueStatistics GetQueueStatistics() const;
+
+        /// Presented, dropped and late frame counts since the last Rewind. Always empty unless in PresentationDeadline mode.
+        [[nodiscard]] PresentationStatistics<LONGLONG> GetPresentationStatistics() const;
         void Rewind(bool looping);
+
+        /// Returns the latest frame due at current_time, or empty if it was already returned.
+        /// In LowLatency mode current_time is ignored and the newest decoded frame is returned.
         [[nodiscard]] MfVideoFrameSample FetchFrame(LONGLONG current_time);
 
     };
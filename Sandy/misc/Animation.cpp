@@ -0,0 +1,249 @@
+/// @file
+///	@brief   sandy::AnimationTracks
+///	@author  (C) 2023 ttsuki
+
+#include "./Animation.h"
+
+#include <limits>
+#include <stdexcept>
+
+namespace sandy
+{
+    static arkxmm::vf32x4 to_f32x4(float v) noexcept { return arkxmm::f32x4(v, 0.0f, 0.0f, 0.0f); }
+    static arkxmm::vf32x4 to_f32x4(Vec2 v) noexcept { return v.v; }
+    static arkxmm::vf32x4 to_f32x4(Vec3 v) noexcept { return v.v; }
+    static arkxmm::vf32x4 to_f32x4(Vec4 v) noexcept { return v.v; }
+    static arkxmm::vf32x4 to_f32x4(Color4 v) noexcept { return v.value; }
+
+    template <class T>
+    static T from_f32x4(arkxmm::vf32x4 v) noexcept
+    {
+        if constexpr (std::is_same_v<T, float>) return arkxmm::extract_element<0>(v);
+        else return T{v};
+    }
+
+    // Segment s spans keys [s, s + 1] and covers times[s] <= time < times[s + 1]; the first/last segments also cover the clamped ends.
+    // Called when time has left the cached segment: steps to the next one, or binary searches on jumps.
+    static uint32_t find_segment(const float times[], uint32_t last, uint32_t cached, float time) noexcept
+    {
+        if (time >= times[cached])
+        {
+            uint32_t s = std::min(cached + 1, last); // a zero-length last segment is left on its own side of the step
+            if (s < last && times[s + 1] <= time)
+                s = static_cast<uint32_t>(std::upper_bound(times + s + 1, times + last + 1, time) - (times + 1));
+            return s;
+        }
+        return static_cast<uint32_t>(std::upper_bound(times + 1, times + cached + 1, time) - (times + 1));
+    }
+
+    template <class T>
+    auto AnimationTracks<T>::add(const AnimationKey<T> keys[], size_t count, Interpolation interpolation) -> Index
+    {
+        if (count == 0) throw std::invalid_argument("count");
+        for (size_t k = 1; k < count; k++)
+            if (!(keys[k - 1].time <= keys[k].time))
+                throw std::invalid_argument("keys must be sorted by time");
+        if (times_.size() + count > UINT32_MAX || tracks_.size() >= UINT32_MAX) throw std::length_error("too many keys");
+
+        Track track{};
+        track.first_key = static_cast<uint32_t>(times_.size());
+        track.key_count = static_cast<uint32_t>(count);
+        track.segment = 0;
+        track.interpolation = interpolation;
+
+        for (size_t k = 0; k < count; k++)
+        {
+            arkxmm::vf32x4 tangent = arkxmm::zero<arkxmm::vf32x4>();
+            if (interpolation == Interpolation::Hermite)
+            {
+                tangent = to_f32x4(keys[k].tangent);
+            }
+            else if (interpolation == Interpolation::CatmullRom && count >= 2)
+            {
+                // (p[k+1] - p[k-1]) / (t[k+1] - t[k-1]); the ends mirror the neighbouring interval, i.e. catmull_rom(p0, p0, p1, p2).
+                size_t prev = k > 0 ? k - 1 : 0;
+                size_t next = k + 1 < count ? k + 1 : count - 1;
+                float prev_time = k > 0 ? keys[prev].time : 2.0f * keys[0].time - keys[1].time;
+                float next_time = k + 1 < count ? keys[next].time : 2.0f * keys[count - 1].time - keys[count - 2].time;
+                if (next_time > prev_time)
+                    tangent = (to_f32x4(keys[next].value) - to_f32x4(keys[prev].value)) / (next_time - prev_time);
+            }
+
+            times_.push_back(keys[k].time);
+            values_.push_back(keys[k].value);
+            tangents_.push_back(from_f32x4<T>(tangent));
+        }
+
+        const size_t index = tracks_.size();
+        tracks_.push_back(track);
+
+        // padding tracks are valid for any time and evaluate to zero.
+        const size_t padded = (tracks_.size() + 7) & ~size_t{7};
+        cache_[cache_from].resize(padded, -std::numeric_limits<float>::infinity());
+        cache_[cache_to].resize(padded, std::numeric_limits<float>::infinity());
+        for (size_t c = cache_t0; c < std::size(cache_); c++)
+            cache_[c].resize(padded, 0.0f);
+
+        update_cache(index, 0, -std::numeric_limits<float>::infinity());
+        return static_cast<Index>(index);
+    }
+
+    template <class T>
+    void AnimationTracks<T>::clear() noexcept
+    {
+        tracks_.clear();
+        times_.clear();
+        values_.clear();
+        tangents_.clear();
+        for (auto& c : cache_) c.clear();
+    }
+
+    template <class T>
+    void AnimationTracks<T>::update_cache(size_t index, uint32_t segment, float time) noexcept
+    {
+        using namespace arkxmm;
+
+        Track& track = tracks_[index];
+        track.segment = segment;
+
+        const uint32_t last = track.key_count >= 2 ? track.key_count - 2 : 0;
+        const uint32_t k0 = track.first_key + segment;
+        const uint32_t k1 = track.first_key + std::min(segment + 1, track.key_count - 1);
+        const float t0 = times_[k0];
+        const float dt = times_[k1] - t0;
+
+        float from = segment == 0 ? -std::numeric_limits<float>::infinity() : t0;
+        float to = segment == last ? std::numeric_limits<float>::infinity() : times_[k1];
+        vf32x4 p0 = to_f32x4(values_[k0]);
+        vf32x4 p1 = to_f32x4(values_[k1]);
+
+        // a zero-length segment steps to its second key at t0, e.g. a trailing key repeating the last time.
+        // time can only fall in one as the first or the last segment; cache the constant on its side of the step.
+        if (k1 != k0 && !(dt > 0.0f))
+        {
+            if (time >= t0)
+            {
+                from = t0;
+                p0 = p1;
+            }
+            else
+            {
+                to = t0;
+                p1 = p0;
+            }
+        }
+
+        cache_[cache_from][index] = from;
+        cache_[cache_to][index] = to;
+        cache_[cache_t0][index] = t0;
+        cache_[cache_rate][index] = dt > 0.0f ? 1.0f / dt : 0.0f;
+
+        // power basis of the segment: leap() for Linear, hermite() with tangents scaled to the segment length otherwise.
+        vf32x4 c[4] = {p0, p1 - p0, zero<vf32x4>(), zero<vf32x4>()};
+        if (track.interpolation != Interpolation::Linear)
+        {
+            const vf32x4 m0 = to_f32x4(tangents_[k0]) * dt;
+            const vf32x4 m1 = to_f32x4(tangents_[k1]) * dt;
+            c[1] = m0;
+            c[2] = (p1 - p0) * 3.0f - m0 * 2.0f - m1;
+            c[3] = (p0 - p1) * 2.0f + m0 + m1;
+        }
+
+        for (size_t power = 0; power < 4; power++)
+        {
+            auto e = to_array(c[power]);
+            for (size_t component = 0; component < components; component++)
+                cache_[cache_c0 + power * components + component][index] = e[component];
+        }
+    }
+
+    template <class T>
+    void AnimationTracks<T>::evaluate(float time, T dst[]) noexcept
+    {
+        evaluate(&time, 0, dst);
+    }
+
+    template <class T>
+    void AnimationTracks<T>::evaluate(const float time[], T dst[]) noexcept
+    {
+        evaluate(time, 1, dst);
+    }
+
+    template <class T>
+    void AnimationTracks<T>::evaluate(const float time[], size_t time_stride, T dst[]) noexcept
+    {
+        using namespace arkxmm;
+        const size_t count = tracks_.size();
+
+        for (size_t i = 0; i < count; i += 8)
+        {
+            const size_t lanes = std::min<size_t>(count - i, 8);
+
+            alignas(32) float now[8]{};
+            for (size_t j = 0; j < lanes; j++)
+                now[j] = time[(i + j) * time_stride];
+            const vf32x8 t = time_stride == 0 ? f32x8(time[0]) : load_u<vf32x8>(now);
+
+            // refresh lanes whose time left the cached segment.
+            auto load = [i, this](size_t k) { return load_u<vf32x8>(cache_[k].data() + i); };
+            const vf32x8 inside = compare<_CMP_GE_OQ>(t, load(cache_from)) & compare<_CMP_LT_OQ>(t, load(cache_to));
+            for (uint32_t stale = ~static_cast<uint32_t>(_mm256_movemask_ps(inside.v)) & ((1u << lanes) - 1); stale; stale &= stale - 1)
+            {
+                const size_t n = i + _tzcnt_u32(stale);
+                const Track& track = tracks_[n];
+                const uint32_t last = track.key_count >= 2 ? track.key_count - 2 : 0;
+                update_cache(n, find_segment(times_.data() + track.first_key, last, track.segment, now[n - i]), now[n - i]);
+            }
+
+            const vf32x8 u = min(max((t - load(cache_t0)) * load(cache_rate), 0.0f), 1.0f);
+            auto component = [&](size_t c)
+            {
+                if (c >= components) return zero<vf32x8>();
+                auto coefficient = [&](size_t power) { return load(cache_c0 + power * components + c); };
+                return coefficient(0) + u * (coefficient(1) + u * (coefficient(2) + u * coefficient(3)));
+            };
+
+            if constexpr (std::is_same_v<T, float>)
+            {
+                const vf32x8 x = component(0);
+                if (lanes == 8) store_u<vf32x8>(dst + i, x);
+                else std::copy_n(to_array(x).data(), lanes, dst + i);
+            }
+            else
+            {
+                const vf32x8 x = component(0);
+                const vf32x8 y = component(1);
+                const vf32x8 z = component(2);
+                const vf32x8 w = component(3);
+
+                // {x0..x7}, {y0..y7}, ... -> {x0,y0,z0,w0}, ...
+                vf32x4 r0 = lower128(x), r1 = lower128(y), r2 = lower128(z), r3 = lower128(w);
+                vf32x4 r4 = higher128(x), r5 = higher128(y), r6 = higher128(z), r7 = higher128(w);
+                transpose_32x4x4(r0, r1, r2, r3);
+                transpose_32x4x4(r4, r5, r6, r7);
+                if (lanes == 8)
+                {
+                    dst[i + 0] = T{r0};
+                    dst[i + 1] = T{r1};
+                    dst[i + 2] = T{r2};
+                    dst[i + 3] = T{r3};
+                    dst[i + 4] = T{r4};
+                    dst[i + 5] = T{r5};
+                    dst[i + 6] = T{r6};
+                    dst[i + 7] = T{r7};
+                }
+                else
+                {
+                    const vf32x4 r[8] = {r0, r1, r2, r3, r4, r5, r6, r7};
+                    std::copy_n(r, lanes, dst + i);
+                }
+            }
+        }
+    }
+
+    template class AnimationTracks<float>;
+    template class AnimationTracks<Vec2>;
+    template class AnimationTracks<Vec3>;
+    template class AnimationTracks<Vec4>;
+    template class AnimationTracks<Color4>;
+}
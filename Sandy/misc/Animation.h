@@ -0,0 +1,96 @@
+/// @file
+///	@brief   sandy::AnimationTracks
+///	@author  (C) 2023 ttsuki
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "./Math.h"
+
+namespace sandy
+{
+    enum struct Interpolation : uint8_t
+    {
+        Linear,     // leap() between keys
+        Hermite,    // hermite() with per-key tangents
+        CatmullRom, // catmull_rom(), tangents derived from neighbouring keys
+    };
+
+    template <class T>
+    struct AnimationKey
+    {
+        float time{};
+        T value{};
+        T tangent{}; // Hermite only: slope at this key, in value per unit time
+    };
+
+    /// Keyframe tracks of float, Vec2, Vec3, Vec4 or Color4, evaluated 8 tracks per iteration.
+    /// Each track caches its current segment as cubic coefficients in SoA arrays; while time stays inside the segment,
+    /// evaluation is contiguous SIMD loads and a Horner step per component. Leaving it (once per key for monotonic time) re-runs the key lookup.
+    template <class T>
+    class AnimationTracks final
+    {
+    public:
+        using Index = uint32_t;
+
+    private:
+        static constexpr size_t components =
+            std::is_same_v<T, float> ? 1 :
+            std::is_same_v<T, Vec2> ? 2 :
+            std::is_same_v<T, Vec3> ? 3 : 4;
+
+        struct Track
+        {
+            uint32_t first_key;
+            uint32_t key_count;
+            uint32_t segment; // cached segment, [0, max(key_count - 1, 1))
+            Interpolation interpolation;
+        };
+
+        // keys
+        std::vector<Track> tracks_{};
+        std::vector<float> times_{};
+        std::vector<T> values_{};
+        std::vector<T> tangents_{}; // value per unit time
+
+        // segment cache, one element per track, padded to a multiple of 8 tracks:
+        // valid while from <= time < to, value = c0 + u * (c1 + u * (c2 + u * c3)) with u = clamp((time - t0) * rate, 0, 1).
+        enum : size_t { cache_from, cache_to, cache_t0, cache_rate, cache_c0 }; // cache_c0 + power * components + component
+        std::vector<float> cache_[cache_c0 + 4 * components]{};
+
+        void update_cache(size_t track, uint32_t segment, float time) noexcept; // time picks the side of a zero-length segment
+        void evaluate(const float time[], size_t time_stride, T dst[]) noexcept;
+
+    public:
+        AnimationTracks() = default;
+        AnimationTracks(const AnimationTracks& other) = default;
+        AnimationTracks(AnimationTracks&& other) noexcept = default;
+        AnimationTracks& operator=(const AnimationTracks& other) = default;
+        AnimationTracks& operator=(AnimationTracks&& other) noexcept = default;
+        ~AnimationTracks() = default;
+
+        /// Appends a track. keys must be non-empty and sorted by time.
+        /// Evaluation clamps to the first/last key outside [keys[0].time, keys[count - 1].time].
+        Index add(const AnimationKey<T> keys[], size_t count, Interpolation interpolation);
+
+        void clear() noexcept;
+
+        [[nodiscard]] size_t size() const noexcept { return tracks_.size(); }
+        [[nodiscard]] float begin_time(Index track) const noexcept { return times_[tracks_[track].first_key]; }
+        [[nodiscard]] float end_time(Index track) const noexcept { return times_[tracks_[track].first_key + tracks_[track].key_count - 1]; }
+
+        // dst[i] = track i at time (or time[i]), for all size() tracks.
+        // dst is a plain T array, e.g. Vec3 scales/translations for scale_rotate_translate() or Color4 vertex colors.
+        void evaluate(float time, T dst[]) noexcept;
+        void evaluate(const float time[], T dst[]) noexcept;
+    };
+
+    extern template class AnimationTracks<float>;
+    extern template class AnimationTracks<Vec2>;
+    extern template class AnimationTracks<Vec3>;
+    extern template class AnimationTracks<Vec4>;
+    extern template class AnimationTracks<Color4>;
+}
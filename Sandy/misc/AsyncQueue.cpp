@@ -0,0 +1,5 @@
+/// @file
+///	@brief   sandy::AsyncQueue
+///	@author  (C) 2023 ttsuki
+
+#include "./AsyncQueue.h"
@@ -0,0 +1,325 @@
+/// @file
+///	@brief   sandy::AsyncQueue
+///	@author  (C) 2023 ttsuki
+
+#pragma once
+
+#include "./AsyncTask.h"
+
+#if SANDY_COROUTINES
+
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <coroutine>
+#include <optional>
+#include <limits>
+#include <utility>
+
+#include "./QueueStatistics.h"
+#include "./TaskScheduler.h"
+
+namespace sandy
+{
+    /// Bounded queue for coroutines: co_await push(value) suspends while the queue is full, co_await pop() while it is empty.
+    /// A suspended coroutine holds no thread; whoever makes room or pushes resumes it as a task on the scheduler.
+    /// Values go straight to a waiting consumer, bypassing the queue. Also usable from plain threads with try_push/try_pop.
+    /// Capacity 0 is a rendezvous: push() waits until a pop takes its value, and try_push succeeds only into a waiting pop().
+    template <class T>
+    class AsyncQueue final
+    {
+        // a suspended push() or pop(), linked in its coroutine frame.
+        struct Waiter
+        {
+            Waiter* next{};
+            std::coroutine_handle<> handle{};
+        };
+
+        struct FifoList
+        {
+            Waiter* head{};
+            Waiter* tail{};
+
+            [[nodiscard]] bool empty() const noexcept { return head == nullptr; }
+
+            void push_back(Waiter* waiter) noexcept
+            {
+                waiter->next = nullptr;
+                (tail ? tail->next : head) = waiter;
+                tail = waiter;
+            }
+
+            Waiter* pop_front() noexcept
+            {
+                Waiter* waiter = head;
+                if (waiter && !(head = waiter->next)) tail = nullptr;
+                return waiter;
+            }
+        };
+
+    public:
+        class PushAwaiter;
+        class PopAwaiter;
+
+    private:
+        mutable std::mutex mutex_{};
+        TaskScheduler& scheduler_;
+        const size_t capacity_{};
+        std::deque<T> queue_{};
+        FifoList producers_{}; // PushAwaiters waiting for room
+        FifoList consumers_{}; // PopAwaiters waiting for a value
+        bool closed_{};
+        QueueStatisticsRecorder statistics_{};
+
+        void resume(std::coroutine_handle<> handle)
+        {
+            scheduler_.submit([handle] { handle.resume(); });
+        }
+
+        // hands value to a waiting consumer, or queues it. Returns the consumer to resume. mutex_ must be held, with room or a consumer.
+        std::coroutine_handle<> deliver(T&& value);
+
+        // moves the front value to out, refilling from a waiting producer, or takes a waiting producer's value directly
+        // when nothing is queued (capacity 0). Returns the producer to resume. mutex_ must be held.
+        std::coroutine_handle<> take(std::optional<T>& out);
+
+    public:
+        explicit AsyncQueue(size_t capacity = std::numeric_limits<size_t>::max(), TaskScheduler& scheduler = TaskScheduler::shared())
+            : scheduler_(scheduler)
+            , capacity_(capacity) { }
+
+        AsyncQueue(const AsyncQueue& other) = delete;
+        AsyncQueue(AsyncQueue&& other) noexcept = delete;
+        AsyncQueue& operator=(const AsyncQueue& other) = delete;
+        AsyncQueue& operator=(AsyncQueue&& other) noexcept = delete;
+
+        /// No coroutine may still be suspended on the queue.
+        ~AsyncQueue() = default;
+
+        [[nodiscard]] bool closed() const noexcept
+        {
+            std::lock_guard lock(mutex_);
+            return queue_.empty() && closed_;
+        }
+
+        [[nodiscard]] bool empty() const noexcept
+        {
+            std::lock_guard lock(mutex_);
+            return queue_.empty();
+        }
+
+        [[nodiscard]] size_t capacity() const noexcept
+        {
+            return capacity_;
+        }
+
+        [[nodiscard]] size_t size() const noexcept
+        {
+            std::lock_guard lock(mutex_);
+            return queue_.size();
+        }
+
+        /// Counters since construction or reset_statistics(); all zero unless SANDY_QUEUE_STATISTICS is enabled.
+        /// Waits are counted, their time is not.
+        [[nodiscard]] QueueStatistics statistics() const noexcept
+        {
+            return statistics_.snapshot();
+        }
+
+        void reset_statistics() noexcept
+        {
+            statistics_.reset();
+        }
+
+        /// co_await push(value): true once queued, false if the queue is closed.
+        [[nodiscard]] PushAwaiter push(T value) { return PushAwaiter(*this, std::move(value)); }
+
+        /// co_await pop(): the next value, nullopt once the queue is closed and drained.
+        [[nodiscard]] PopAwaiter pop() { return PopAwaiter(*this); }
+
+        /// Pushes value if there is room. Returns false if the queue is full or closed.
+        bool try_push(T value)
+        {
+            std::coroutine_handle<> consumer{};
+            {
+                std::lock_guard lock(mutex_);
+                if (closed_ || (consumers_.empty() && queue_.size() >= capacity_))
+                {
+                    statistics_.rejected();
+                    return false;
+                }
+                consumer = deliver(std::move(value));
+            }
+            if (consumer) resume(consumer);
+            return true;
+        }
+
+        /// Pops a value if there is one.
+        [[nodiscard]] std::optional<T> try_pop()
+        {
+            std::optional<T> value{};
+            std::coroutine_handle<> producer{};
+            {
+                std::lock_guard lock(mutex_);
+                statistics_.sample([&] { return queue_.size(); }, capacity_);
+                producer = take(value);
+            }
+            if (producer) resume(producer);
+            if (!value) statistics_.missed();
+            return value;
+        }
+
+        /// Closes queue. Suspended pushes return false, suspended pops nullopt; values already queued can still be popped.
+        void close();
+
+        class PushAwaiter final : Waiter
+        {
+            friend class AsyncQueue;
+            AsyncQueue& queue_;
+            std::optional<T> value_{};
+            bool pushed_{};
+
+        public:
+            PushAwaiter(AsyncQueue& queue, T&& value) : queue_(queue), value_(std::move(value)) { }
+            PushAwaiter(const PushAwaiter& other) = delete;
+            PushAwaiter& operator=(const PushAwaiter& other) = delete;
+
+            bool await_ready() noexcept { return false; }
+
+            bool await_suspend(std::coroutine_handle<> handle)
+            {
+                std::coroutine_handle<> consumer{};
+                {
+                    std::lock_guard lock(queue_.mutex_);
+                    if (queue_.closed_)
+                    {
+                        queue_.statistics_.rejected();
+                        return false;
+                    }
+
+                    if (queue_.consumers_.empty() && queue_.queue_.size() >= queue_.capacity_)
+                    {
+                        (void)queue_.statistics_.producer_wait(); // counted only: the wait outlives this call
+                        this->handle = handle;
+                        queue_.producers_.push_back(this);
+                        return true; // take() or close() resumes it; *this must not be touched after unlocking
+                    }
+
+                    consumer = queue_.deliver(std::move(*value_));
+                    pushed_ = true;
+                }
+                if (consumer) queue_.resume(consumer);
+                return false;
+            }
+
+            bool await_resume() noexcept { return pushed_; }
+        };
+
+        class PopAwaiter final : Waiter
+        {
+            friend class AsyncQueue;
+            AsyncQueue& queue_;
+            std::optional<T> value_{};
+
+        public:
+            explicit PopAwaiter(AsyncQueue& queue) : queue_(queue) { }
+            PopAwaiter(const PopAwaiter& other) = delete;
+            PopAwaiter& operator=(const PopAwaiter& other) = delete;
+
+            bool await_ready() noexcept { return false; }
+
+            bool await_suspend(std::coroutine_handle<> handle)
+            {
+                std::coroutine_handle<> producer{};
+                {
+                    std::lock_guard lock(queue_.mutex_);
+                    queue_.statistics_.sample([&] { return queue_.queue_.size(); }, queue_.capacity_);
+                    if (queue_.queue_.empty() && queue_.producers_.empty() && !queue_.closed_)
+                    {
+                        (void)queue_.statistics_.consumer_wait();
+                        this->handle = handle;
+                        queue_.consumers_.push_back(this);
+                        return true; // deliver() or close() resumes it
+                    }
+
+                    producer = queue_.take(value_);
+                    if (!value_) queue_.statistics_.missed();
+                }
+                if (producer) queue_.resume(producer);
+                return false;
+            }
+
+            std::optional<T> await_resume() { return std::move(value_); }
+        };
+    };
+
+    template <class T>
+    std::coroutine_handle<> AsyncQueue<T>::deliver(T&& value)
+    {
+        statistics_.pushed();
+        if (Waiter* waiter = consumers_.pop_front())
+        {
+            auto* consumer = static_cast<PopAwaiter*>(waiter);
+            consumer->value_.emplace(std::move(value));
+            statistics_.popped();
+            return consumer->handle;
+        }
+
+        queue_.push_back(std::move(value));
+        return {};
+    }
+
+    template <class T>
+    std::coroutine_handle<> AsyncQueue<T>::take(std::optional<T>& out)
+    {
+        if (queue_.empty())
+        {
+            Waiter* waiter = producers_.pop_front();
+            if (!waiter) return {};
+
+            auto* producer = static_cast<PushAwaiter*>(waiter);
+            out.emplace(std::move(*producer->value_));
+            producer->pushed_ = true;
+            statistics_.pushed();
+            statistics_.popped();
+            return producer->handle;
+        }
+
+        out.emplace(std::move(queue_.front()));
+        queue_.pop_front();
+        statistics_.popped();
+
+        if (Waiter* waiter = producers_.pop_front())
+        {
+            auto* producer = static_cast<PushAwaiter*>(waiter);
+            queue_.push_back(std::move(*producer->value_));
+            producer->pushed_ = true;
+            statistics_.pushed();
+            return producer->handle;
+        }
+        return {};
+    }
+
+    template <class T>
+    void AsyncQueue<T>::close()
+    {
+        FifoList producers{}, consumers{};
+        {
+            std::lock_guard lock(mutex_);
+            closed_ = true;
+            std::swap(producers, producers_);
+            std::swap(consumers, consumers_);
+        }
+
+        // their awaiters still say "not pushed" and "no value".
+        while (Waiter* waiter = producers.pop_front())
+        {
+            statistics_.rejected();
+            resume(waiter->handle);
+        }
+        while (Waiter* waiter = consumers.pop_front())
+            resume(waiter->handle);
+    }
+}
+
+#endif
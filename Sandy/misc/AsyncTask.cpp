@@ -0,0 +1,5 @@
+/// @file
+///	@brief   sandy::AsyncTask
+///	@author  (C) 2023 ttsuki
+
+#include "./AsyncTask.h"
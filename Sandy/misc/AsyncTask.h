@@ -0,0 +1,273 @@
+/// @file
+///	@brief   sandy::AsyncTask, sandy::AsyncScope
+///	@author  (C) 2023 ttsuki
+
+#pragma once
+
+// Coroutine support: 1 if the compiler has C++20 coroutines, e.g. with the project built as
+// `msbuild Sandy.vcxproj /p:SandyLanguageStandard=stdcpp20`. The C++17 build sees none of it.
+#if !defined(SANDY_COROUTINES)
+#if defined(__cpp_impl_coroutine) && __cpp_impl_coroutine >= 201902L && __has_include(<coroutine>)
+#define SANDY_COROUTINES 1
+#else
+#define SANDY_COROUTINES 0
+#endif
+#endif
+
+#if SANDY_COROUTINES
+
+#include <cstddef>
+#include <atomic>
+#include <mutex>
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+#include "./TaskScheduler.h"
+
+namespace sandy
+{
+    template <class T = void>
+    class AsyncTask;
+
+    class AsyncScope;
+
+    namespace async_detail
+    {
+        struct PromiseBase
+        {
+            std::coroutine_handle<> continuation{}; // coroutine awaiting this one
+            AsyncScope* scope{};                    // or the scope that spawned it
+            std::exception_ptr error{};
+
+            struct FinalAwaiter
+            {
+                bool await_ready() noexcept { return false; }
+                template <class Promise> std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> self) noexcept;
+                void await_resume() noexcept { }
+            };
+
+            std::suspend_always initial_suspend() noexcept { return {}; }
+            FinalAwaiter final_suspend() noexcept { return {}; }
+            void unhandled_exception() noexcept { error = std::current_exception(); }
+        };
+
+        template <class T>
+        struct Promise : PromiseBase
+        {
+            std::optional<T> value{};
+
+            AsyncTask<T> get_return_object() noexcept;
+            template <class U> void return_value(U&& v) { value.emplace(std::forward<U>(v)); }
+
+            T result()
+            {
+                if (error) std::rethrow_exception(error);
+                return std::move(*value);
+            }
+        };
+
+        template <>
+        struct Promise<void> : PromiseBase
+        {
+            AsyncTask<void> get_return_object() noexcept;
+            void return_void() noexcept { }
+
+            void result()
+            {
+                if (error) std::rethrow_exception(error);
+            }
+        };
+    }
+
+    /// Lazily started coroutine returning T. co_await starts it and resumes the awaiting coroutine when it returns,
+    /// rethrowing its exception. Run a top-level one with AsyncScope::spawn or sync_wait.
+    template <class T>
+    class AsyncTask final
+    {
+    public:
+        using promise_type = async_detail::Promise<T>;
+
+    private:
+        friend class AsyncScope;
+        std::coroutine_handle<promise_type> handle_{};
+
+    public:
+        explicit AsyncTask(std::coroutine_handle<promise_type> handle) noexcept : handle_(handle) { }
+        AsyncTask(const AsyncTask& other) = delete;
+        AsyncTask(AsyncTask&& other) noexcept : handle_(std::exchange(other.handle_, {})) { }
+        AsyncTask& operator=(const AsyncTask& other) = delete;
+
+        AsyncTask& operator=(AsyncTask&& other) noexcept
+        {
+            if (this != &other)
+            {
+                if (handle_) handle_.destroy();
+                handle_ = std::exchange(other.handle_, {});
+            }
+            return *this;
+        }
+
+        /// Must not be destroyed while the coroutine is suspended in the middle.
+        ~AsyncTask()
+        {
+            if (handle_) handle_.destroy();
+        }
+
+        auto operator co_await() && noexcept
+        {
+            struct Awaiter
+            {
+                std::coroutine_handle<promise_type> handle;
+
+                bool await_ready() noexcept { return false; }
+
+                std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept
+                {
+                    handle.promise().continuation = awaiting;
+                    return handle;
+                }
+
+                T await_resume() { return handle.promise().result(); }
+            };
+            return Awaiter{handle_};
+        }
+    };
+
+    namespace async_detail
+    {
+        template <class T>
+        AsyncTask<T> Promise<T>::get_return_object() noexcept { return AsyncTask<T>(std::coroutine_handle<Promise>::from_promise(*this)); }
+        inline AsyncTask<void> Promise<void>::get_return_object() noexcept { return AsyncTask<void>(std::coroutine_handle<Promise>::from_promise(*this)); }
+    }
+
+    /// Runs AsyncTask<void>s on a scheduler and waits for all of them, like TaskGroup does for plain tasks.
+    class AsyncScope final
+    {
+        friend struct async_detail::PromiseBase::FinalAwaiter;
+
+        TaskScheduler& scheduler_;
+        std::atomic<size_t> pending_{};
+        std::mutex error_mutex_{};
+        std::exception_ptr error_{};
+
+        void finish(std::exception_ptr error) noexcept
+        {
+            if (error)
+            {
+                std::lock_guard lock(error_mutex_);
+                if (!error_) error_ = std::move(error);
+            }
+
+            TaskScheduler& scheduler = scheduler_; // *this is gone once pending_ reaches 0
+            if (pending_.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                scheduler.notify();
+        }
+
+    public:
+        explicit AsyncScope(TaskScheduler& scheduler = TaskScheduler::shared()) : scheduler_(scheduler) { }
+        AsyncScope(const AsyncScope& other) = delete;
+        AsyncScope(AsyncScope&& other) noexcept = delete;
+        AsyncScope& operator=(const AsyncScope& other) = delete;
+        AsyncScope& operator=(AsyncScope&& other) noexcept = delete;
+
+        /// Waits for the coroutines still running; an exception not collected by wait() is dropped.
+        ~AsyncScope()
+        {
+            try
+            {
+                wait();
+            }
+            catch (...)
+            {
+                // dropped, see declaration.
+            }
+        }
+
+        [[nodiscard]] TaskScheduler& scheduler() const noexcept { return scheduler_; }
+
+        /// Starts task on the scheduler. The scope owns the coroutine frame until it returns.
+        void spawn(AsyncTask<void> task)
+        {
+            auto handle = std::exchange(task.handle_, {});
+            handle.promise().scope = this;
+            pending_.fetch_add(1, std::memory_order_relaxed);
+            try
+            {
+                scheduler_.submit([handle] { handle.resume(); });
+            }
+            catch (...)
+            {
+                pending_.fetch_sub(1, std::memory_order_relaxed);
+                handle.destroy();
+                throw;
+            }
+        }
+
+        /// Runs scheduler tasks on the calling thread until every spawned coroutine has returned.
+        /// Rethrows the first exception one of them let escape.
+        void wait()
+        {
+            scheduler_.run_until([this] { return pending_.load(std::memory_order_acquire) == 0; });
+
+            std::exception_ptr error{};
+            {
+                std::lock_guard lock(error_mutex_);
+                error = std::exchange(error_, nullptr);
+            }
+            if (error) std::rethrow_exception(error);
+        }
+    };
+
+    template <class Promise>
+    std::coroutine_handle<> async_detail::PromiseBase::FinalAwaiter::await_suspend(std::coroutine_handle<Promise> self) noexcept
+    {
+        PromiseBase& promise = self.promise();
+        if (promise.continuation) return promise.continuation;
+
+        if (AsyncScope* scope = promise.scope)
+        {
+            std::exception_ptr error = std::move(promise.error);
+            self.destroy();
+            scope->finish(std::move(error));
+        }
+        return std::noop_coroutine();
+    }
+
+    /// co_await schedule(scheduler) continues the calling coroutine as a task on scheduler.
+    [[nodiscard]] inline auto schedule(TaskScheduler& scheduler = TaskScheduler::shared()) noexcept
+    {
+        struct Awaiter
+        {
+            TaskScheduler& scheduler;
+
+            bool await_ready() noexcept { return false; }
+            void await_suspend(std::coroutine_handle<> handle) { scheduler.submit([handle] { handle.resume(); }); }
+            void await_resume() noexcept { }
+        };
+        return Awaiter{scheduler};
+    }
+
+    /// Runs task to completion, lending the calling thread to scheduler meanwhile, and returns its result.
+    template <class T>
+    T sync_wait(AsyncTask<T> task, TaskScheduler& scheduler = TaskScheduler::shared())
+    {
+        AsyncScope scope(scheduler);
+        if constexpr (std::is_void_v<T>)
+        {
+            scope.spawn(std::move(task));
+            scope.wait();
+        }
+        else
+        {
+            std::optional<T> result{};
+            scope.spawn([](AsyncTask<T> t, std::optional<T>& r) -> AsyncTask<void> { r.emplace(co_await std::move(t)); }(std::move(task), result));
+            scope.wait();
+            return std::move(*result);
+        }
+    }
+}
+
+#endif
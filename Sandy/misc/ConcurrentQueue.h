@@ -5,31 +5,91 @@
 #pragma once
 
 #include <cstddef>
-#include <queue>
+#include <deque>
+#include <algorithm>
 #include <mutex>
 #include <condition_variable>
 #include <optional>
 #include <limits>
 #include <chrono>
+#include <functional>
+
+#include "./QueueStatistics.h"
 
 namespace sandy
 {
     template <class T>
     class ConcurrentQueue final
     {
-        mutable std::recursive_mutex mutex_{};
+    public:
+        /// Weight of an element in capacity units, e.g. its size in bytes. Must not change while the element is queued.
+        using weight_function = std::function<size_t(const T&)>;
+
+    private:
+        mutable std::mutex mutex_{};
         const size_t capacity_{};
+        const weight_function weight_of_{};
+        size_t weight_{}; // total weight of queue_
 
-        std::condition_variable_any can_produce_{};
-        std::condition_variable_any can_consume_{};
-        std::queue<std::optional<T>> queue_{};
+        std::condition_variable can_produce_{};
+        std::condition_variable can_consume_{};
+        std::deque<T> queue_{};
         bool closed_{};
+        QueueStatisticsRecorder statistics_{};
+
+        [[nodiscard]] size_t weigh(const T& value) const { return weight_of_ ? weight_of_(value) : 1; }
+
+        // an element heavier than the whole capacity still goes into an empty queue. mutex_ must be held.
+        [[nodiscard]] bool has_room(size_t weight) const noexcept { return queue_.empty() || weight_ + weight <= capacity_; }
+
+        // one popped unweighted element makes room for exactly one waiting producer. A weighted pop may make room for several,
+        // or only for a lighter one than the producer notify_one would pick, so all of them recheck. mutex_ must be held.
+        void wake_producers(size_t popped)
+        {
+            if (popped == 1 && !weight_of_) can_produce_.notify_one();
+            else can_produce_.notify_all();
+        }
+
+        // moves up to max values from the front to out. mutex_ must be held.
+        template <class OutputIt>
+        size_t take(OutputIt& out, size_t max)
+        {
+            const size_t n = std::min(max, queue_.size());
+            if (n == 0) { return 0; }
+
+            const auto end = queue_.begin() + static_cast<ptrdiff_t>(n);
+            for (auto it = queue_.begin(); it != end; ++it)
+                weight_ -= weigh(*it);
+            out = std::move(queue_.begin(), end, out);
+            queue_.erase(queue_.begin(), end);
+            statistics_.popped(n);
+            wake_producers(n);
+            return n;
+        }
+
+        // mutex_ must be held.
+        std::optional<T> pop_front()
+        {
+            if (queue_.empty()) { return std::nullopt; }
+
+            weight_ -= weigh(queue_.front());
+            std::optional<T> ret(std::move(queue_.front()));
+            queue_.pop_front();
+            statistics_.popped();
+            wake_producers(1);
+            return ret;
+        }
 
     public:
         ConcurrentQueue(
             size_t limit = std::numeric_limits<size_t>::max())
             : capacity_(limit) { }
 
+        /// Holds elements while their total weight(element) stays within capacity.
+        ConcurrentQueue(size_t capacity, weight_function weight)
+            : capacity_(capacity)
+            , weight_of_(std::move(weight)) { }
+
         ConcurrentQueue(const ConcurrentQueue& other) = delete;
         ConcurrentQueue(ConcurrentQueue&& other) noexcept = delete;
         ConcurrentQueue& operator=(const ConcurrentQueue& other) = delete;
@@ -59,23 +119,69 @@ namespace sandy
             return queue_.size();
         }
 
-        /// Pushes value.
+        /// Total weight of the queued elements; size() without a weight function.
+        [[nodiscard]] size_t weight() const noexcept
+        {
+            std::unique_lock lock(mutex_);
+            return weight_;
+        }
+
+        /// Counters since construction or reset_statistics(); all zero unless SANDY_QUEUE_STATISTICS is enabled.
+        [[nodiscard]] QueueStatistics statistics() const noexcept
+        {
+            return statistics_.snapshot();
+        }
+
+        void reset_statistics() noexcept
+        {
+            statistics_.reset();
+        }
+
+        /// Pushes value, waiting while the queue is full. Returns false if the queue is closed, before or while waiting.
         template <class... U>
         bool emplace(U&&... val)
         {
             std::unique_lock lock(mutex_);
-            if (closed_) { return false; }
+            if (closed_)
+            {
+                statistics_.rejected();
+                return false;
+            }
 
-            can_produce_.wait(lock, [&]
+            // weighing needs the element, so a weighted queue constructs it up front.
+            std::optional<T> value{};
+            size_t weight = 1;
+            if (weight_of_)
             {
-                if (queue_.size() < capacity_)
+                value.emplace(std::forward<U>(val)...);
+                weight = weight_of_(*value);
+            }
+
+            bool pushed = false;
+            auto push = [&]
+            {
+                if (has_room(weight))
                 {
-                    queue_.emplace(std::in_place, std::forward<U>(val)...);
-                    can_consume_.notify_all();
-                    return true;
+                    if (value) queue_.emplace_back(std::move(*value));
+                    else queue_.emplace_back(std::forward<U>(val)...);
+                    weight_ += weight;
+                    statistics_.pushed();
+                    can_consume_.notify_one();
+                    return pushed = true;
                 }
                 return false;
-            });
+            };
+
+            if (!push())
+            {
+                auto wait = statistics_.producer_wait();
+                can_produce_.wait(lock, [&] { return closed_ || push(); });
+                if (!pushed) // closed while waiting
+                {
+                    statistics_.rejected();
+                    return false;
+                }
+            }
 
             return true;
         }
@@ -86,37 +192,141 @@ namespace sandy
             std::unique_lock lock(mutex_);
             closed_ = true;
             can_consume_.notify_all();
+            can_produce_.notify_all();
         }
 
         /// Tries pop value, may returns nullopt if queue is empty or closed.
         [[nodiscard]] std::optional<T> try_pop()
         {
             std::unique_lock lock(mutex_);
+            statistics_.sample([&] { return weight_; }, capacity_);
 
-            if (!queue_.empty())
+            std::optional<T> ret = pop_front();
+            if (!ret) { statistics_.missed(); }
+            return ret;
+        }
+
+        /// Pushes [first, last) in as few critical sections as the capacity allows, waiting while the queue is full.
+        /// Returns the number of elements pushed, less than the range if the queue is closed meanwhile.
+        template <class InputIt>
+        size_t emplace_range(InputIt first, InputIt last)
+        {
+            std::unique_lock lock(mutex_);
+            size_t count = 0;
+            size_t batch = 0; // pushed since the last wake-up
+            auto wake = [&]
+            {
+                if (batch == 0) { return; }
+                statistics_.pushed(batch);
+                count += batch;
+                if (batch == 1) can_consume_.notify_one();
+                else can_consume_.notify_all();
+                batch = 0;
+            };
+
+            for (; first != last; ++first)
             {
-                std::optional<T> ret = std::move(queue_.front());
-                queue_.pop();
+                T value(*first);
+                const size_t weight = weigh(value);
+                if (!closed_ && !has_room(weight))
+                {
+                    wake();
+                    auto wait = statistics_.producer_wait();
+                    can_produce_.wait(lock, [&] { return closed_ || has_room(weight); });
+                }
+
+                if (closed_)
+                {
+                    statistics_.rejected();
+                    break;
+                }
+
+                queue_.emplace_back(std::move(value));
+                weight_ += weight;
+                batch++;
+            }
+
+            wake();
+            return count;
+        }
+
+        /// Moves up to max queued values to out without waiting. Returns the number of values moved.
+        template <class OutputIt>
+        size_t pop_many(OutputIt out, size_t max = std::numeric_limits<size_t>::max())
+        {
+            std::unique_lock lock(mutex_);
+            statistics_.sample([&] { return weight_; }, capacity_);
+
+            const size_t n = take(out, max);
+            if (n == 0) { statistics_.missed(); }
+            return n;
+        }
+
+        /// Takes all queued values at once.
+        [[nodiscard]] std::deque<T> pop_all()
+        {
+            std::deque<T> ret{};
+            std::unique_lock lock(mutex_);
+            statistics_.sample([&] { return weight_; }, capacity_);
+
+            ret.swap(queue_);
+            weight_ = 0;
+            if (ret.empty()) { statistics_.missed(); }
+            else
+            {
+                statistics_.popped(ret.size());
                 can_produce_.notify_all();
-                return ret;
             }
+            return ret;
+        }
 
-            return std::nullopt;
+        /// Moves values to out as they arrive until the queue is closed and empty. Returns the number of values moved.
+        template <class OutputIt>
+        size_t drain_into(OutputIt out)
+        {
+            std::unique_lock lock(mutex_);
+            size_t count = 0;
+            for (;;)
+            {
+                can_consume_.wait(lock, [&] { return closed_ || !queue_.empty(); });
+                count += take(out, queue_.size());
+                if (closed_) { return count; }
+            }
         }
 
+        /// Destroys values as they arrive until the queue is closed and empty, e.g. to let a blocked producer finish.
+        size_t drain()
+        {
+            std::unique_lock lock(mutex_);
+            size_t count = 0;
+            for (;;)
+            {
+                can_consume_.wait(lock, [&] { return closed_ || !queue_.empty(); });
+                count += queue_.size();
+                statistics_.popped(queue_.size());
+                queue_.clear();
+                weight_ = 0;
+                can_produce_.notify_all();
+                if (closed_) { return count; }
+            }
+        }
 
         /// Waits for value.
         /// may return nullopt if queue is closed.
         [[nodiscard]] std::optional<T> pop_wait()
         {
             std::unique_lock lock(mutex_);
+            statistics_.sample([&] { return weight_; }, capacity_);
 
             std::optional<T> ret{};
-            can_consume_.wait(lock, [&]
+            auto ready = [&] { return (ret = pop_front()).has_value() || closed_; };
+            if (!ready())
             {
-                return closed() || (ret = try_pop()).has_value();
-            });
+                auto wait = statistics_.consumer_wait();
+                can_consume_.wait(lock, ready);
+            }
 
+            if (!ret) { statistics_.missed(); }
             return ret;
         }
 
@@ -126,13 +336,17 @@ namespace sandy
         [[nodiscard]] std::optional<T> pop_wait_for(std::chrono::duration<Rep, Period> timeout)
         {
             std::unique_lock lock(mutex_);
+            statistics_.sample([&] { return weight_; }, capacity_);
 
             std::optional<T> ret{};
-            can_consume_.wait_for(lock, timeout, [&]
+            auto ready = [&] { return (ret = pop_front()).has_value() || closed_; };
+            if (!ready())
             {
-                return closed() || (ret = try_pop()).has_value();
-            });
+                auto wait = statistics_.consumer_wait();
+                can_consume_.wait_for(lock, timeout, ready);
+            }
 
+            if (!ret) { statistics_.missed(); }
             return ret;
         }
     };
@@ -0,0 +1,153 @@
+/// @file
+///	@brief   sandy::culling
+///	@author  (C) 2023 ttsuki
+
+#include "./Culling.h"
+
+#include <array>
+
+namespace sandy
+{
+    Frustum::Frustum(const Matrix4x4& view_projection) noexcept
+        : a{}, b{}, c{}, d{}
+    {
+        // clip = p * M: columns of M are the x, y, z, w clip coordinate functions.
+        Matrix4x4 t = transpose(view_projection);
+        const arkxmm::vf32x4 planes[6] = {
+            t.m3 + t.m0, // left:   -w <= x
+            t.m3 - t.m0, // right:  x <= w
+            t.m3 + t.m1, // bottom: -w <= y
+            t.m3 - t.m1, // top:    y <= w
+            t.m2,        // near:   0 <= z
+            t.m3 - t.m2, // far:    z <= w
+        };
+
+        for (size_t k = 0; k < 6; k++)
+        {
+            auto p = planes[k] / arkxmm::sqrt(arkxmm::dot<0b0111, 0b1111>(planes[k], planes[k]));
+            auto e = arkxmm::to_array(p);
+            a[k] = e[0];
+            b[k] = e[1];
+            c[k] = e[2];
+            d[k] = e[3];
+        }
+    }
+
+    // indices of set bits in an 8-bit mask, packed one byte each, lowest first.
+    static constexpr auto compaction_table = []
+    {
+        std::array<uint64_t, 256> table{};
+        for (uint32_t mask = 0; mask < 256; mask++)
+        {
+            uint32_t n = 0;
+            for (uint32_t bit = 0; bit < 8; bit++)
+                if (mask & (1u << bit))
+                    table[mask] |= static_cast<uint64_t>(bit) << (8 * n++);
+        }
+        return table;
+    }();
+
+    static constexpr auto popcount_table = []
+    {
+        std::array<uint8_t, 256> table{};
+        for (uint32_t mask = 0; mask < 256; mask++)
+            for (uint32_t bit = 0; bit < 8; bit++)
+                table[mask] += (mask >> bit) & 1;
+        return table;
+    }();
+
+    // Appends i + (set bits of mask) to visible[n..]. Always stores 8 indices: visible[] must have room up to n + 8.
+    static inline size_t compact_indices(uint32_t visible[], size_t n, uint32_t i, uint32_t mask) noexcept
+    {
+        __m256i bits = _mm256_cvtepu8_epi32(_mm_cvtsi64_si128(static_cast<int64_t>(compaction_table[mask])));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(visible + n), _mm256_add_epi32(bits, _mm256_set1_epi32(static_cast<int32_t>(i))));
+        return n + popcount_table[mask];
+    }
+
+    // Runs 8-wide tests and compacts surviving indices.
+    // Outside(i) returns a mask with the lanes of i..i+7 that are entirely outside some plane set.
+    template <class Outside, class Scalar>
+    static size_t cull_kernel(size_t count, uint32_t visible[], Outside&& outside, Scalar&& scalar) noexcept
+    {
+        size_t n = 0;
+        size_t i = 0;
+
+        // n <= i, so the 8-index store of compact_indices stays inside visible[0..count).
+        for (; i + 8 <= count; i += 8)
+        {
+            uint32_t mask = ~static_cast<uint32_t>(_mm256_movemask_ps(outside(i).v)) & 0xFF;
+            n = compact_indices(visible, n, static_cast<uint32_t>(i), mask);
+        }
+
+        for (; i < count; i++)
+            if (scalar(i))
+                visible[n++] = static_cast<uint32_t>(i);
+
+        return n;
+    }
+
+    size_t cull(const Frustum& frustum, const BoundingBoxesSoA& boxes, size_t count, uint32_t visible[]) noexcept
+    {
+        using namespace arkxmm;
+
+        // a box is outside a plane if even its corner farthest along the normal, center + sign(n) * extent, is behind it.
+        float abs_a[6], abs_b[6], abs_c[6];
+        for (size_t k = 0; k < 6; k++)
+        {
+            abs_a[k] = std::abs(frustum.a[k]);
+            abs_b[k] = std::abs(frustum.b[k]);
+            abs_c[k] = std::abs(frustum.c[k]);
+        }
+
+        return cull_kernel(
+            count, visible,
+            [&](size_t i)
+            {
+                vf32x8 cx = load_u<vf32x8>(boxes.center_x + i);
+                vf32x8 cy = load_u<vf32x8>(boxes.center_y + i);
+                vf32x8 cz = load_u<vf32x8>(boxes.center_z + i);
+                vf32x8 ex = load_u<vf32x8>(boxes.extent_x + i);
+                vf32x8 ey = load_u<vf32x8>(boxes.extent_y + i);
+                vf32x8 ez = load_u<vf32x8>(boxes.extent_z + i);
+
+                // distance < 0 like the scalar test, so -0.0 (touching) stays visible.
+                const vf32x8 zero = arkxmm::zero<vf32x8>();
+                vf32x8 out = zero;
+                for (size_t k = 0; k < 6; k++)
+                    out = out | (cx * f32x8(frustum.a[k]) + cy * f32x8(frustum.b[k]) + cz * f32x8(frustum.c[k]) + f32x8(frustum.d[k])
+                        + ex * f32x8(abs_a[k]) + ey * f32x8(abs_b[k]) + ez * f32x8(abs_c[k]) < zero);
+                return out;
+            },
+            [&](size_t i)
+            {
+                return intersects(frustum,
+                                  Vec3(boxes.center_x[i], boxes.center_y[i], boxes.center_z[i]),
+                                  Vec3(boxes.extent_x[i], boxes.extent_y[i], boxes.extent_z[i]));
+            });
+    }
+
+    size_t cull(const Frustum& frustum, const BoundingSpheresSoA& spheres, size_t count, uint32_t visible[]) noexcept
+    {
+        using namespace arkxmm;
+
+        return cull_kernel(
+            count, visible,
+            [&](size_t i)
+            {
+                vf32x8 cx = load_u<vf32x8>(spheres.center_x + i);
+                vf32x8 cy = load_u<vf32x8>(spheres.center_y + i);
+                vf32x8 cz = load_u<vf32x8>(spheres.center_z + i);
+                vf32x8 r = load_u<vf32x8>(spheres.radius + i);
+
+                const vf32x8 zero = arkxmm::zero<vf32x8>();
+                vf32x8 out = zero;
+                for (size_t k = 0; k < 6; k++)
+                    out = out | (cx * f32x8(frustum.a[k]) + cy * f32x8(frustum.b[k]) + cz * f32x8(frustum.c[k]) + f32x8(frustum.d[k]) + r < zero);
+                return out;
+            },
+            [&](size_t i)
+            {
+                return intersects(frustum, Vec3(spheres.center_x[i], spheres.center_y[i], spheres.center_z[i]), spheres.radius[i]);
+            });
+    }
+}
@@ -0,0 +1,76 @@
+/// @file
+///	@brief   sandy::culling
+///	@author  (C) 2023 ttsuki
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "./Math.h"
+
+namespace sandy
+{
+    /// View frustum as 6 inward-facing planes, a x + b y + c z + d >= 0 inside.
+    /// Plane normals (a, b, c) are normalized, so sphere radii can be compared directly.
+    struct Frustum
+    {
+        // SoA plane coefficients: left, right, bottom, top, near, far.
+        float a[6];
+        float b[6];
+        float c[6];
+        float d[6];
+
+        /// Extracts planes from a row-vector view-projection matrix (e.g. ViewProjectionMatrix::ViewProjection), D3D clip space 0 <= z <= w.
+        explicit Frustum(const Matrix4x4& view_projection) noexcept;
+    };
+
+    /// Axis-aligned boxes in SoA layout: box i spans center[i] -/+ extent[i].
+    struct BoundingBoxesSoA
+    {
+        const float* center_x;
+        const float* center_y;
+        const float* center_z;
+        const float* extent_x;
+        const float* extent_y;
+        const float* extent_z;
+    };
+
+    /// Spheres in SoA layout.
+    struct BoundingSpheresSoA
+    {
+        const float* center_x;
+        const float* center_y;
+        const float* center_z;
+        const float* radius;
+    };
+
+    /// Tests a single box, conservative: true unless it is entirely outside one plane.
+    inline bool intersects(const Frustum& frustum, Vec3 center, Vec3 extent) noexcept
+    {
+        float cx = center.x(), cy = center.y(), cz = center.z();
+        float ex = extent.x(), ey = extent.y(), ez = extent.z();
+        for (size_t k = 0; k < 6; k++)
+        {
+            float a = frustum.a[k], b = frustum.b[k], c = frustum.c[k];
+            if (a * cx + b * cy + c * cz + frustum.d[k] + std::abs(a) * ex + std::abs(b) * ey + std::abs(c) * ez < 0.0f)
+                return false;
+        }
+        return true;
+    }
+
+    /// Tests a single sphere, conservative: true unless it is entirely outside one plane.
+    inline bool intersects(const Frustum& frustum, Vec3 center, float radius) noexcept
+    {
+        float cx = center.x(), cy = center.y(), cz = center.z();
+        for (size_t k = 0; k < 6; k++)
+            if (frustum.a[k] * cx + frustum.b[k] * cy + frustum.c[k] * cz + frustum.d[k] + radius < 0.0f)
+                return false;
+        return true;
+    }
+
+    // Batch culling, 8 volumes per iteration.
+    // Writes ascending indices of volumes intersecting the frustum to visible[0..count) and returns how many were written.
+    size_t cull(const Frustum& frustum, const BoundingBoxesSoA& boxes, size_t count, uint32_t visible[]) noexcept;
+    size_t cull(const Frustum& frustum, const BoundingSpheresSoA& spheres, size_t count, uint32_t visible[]) noexcept;
+}
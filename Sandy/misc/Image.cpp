@@ -0,0 +1,128 @@
+/// @file
+///	@brief   sandy::Image2d, sandy::ImagePool
+///	@author  (C) 2023 ttsuki
+
+#include "./Image.h"
+
+#include <algorithm>
+#include <new>
+
+namespace sandy
+{
+    static std::byte* allocate_aligned(size_t size)
+    {
+        return static_cast<std::byte*>(::operator new(size, std::align_val_t{ImageBuffer::alignment}));
+    }
+
+    static void free_aligned(std::byte* data) noexcept
+    {
+        ::operator delete(data, std::align_val_t{ImageBuffer::alignment});
+    }
+
+    // Size classes: 64, 80, 96, 112, 128, 160, ... i.e. 2^e * {5, 6, 7, 8} / 4.
+    static size_t size_class(size_t size, size_t& class_size) noexcept
+    {
+        size = std::max<size_t>(size, ImageBuffer::alignment);
+        size_t e = 0;
+        while ((size_t{2} << e) < size) e++; // 2^e < size <= 2^(e + 1)
+        const size_t quarters = (size + (size_t{1} << (e - 2)) - 1) >> (e - 2); // 5..8
+        class_size = quarters << (e - 2);
+        return e * 4 + quarters - 5;
+    }
+
+    ImageBuffer::ImageBuffer(size_t size)
+        : data_(size ? allocate_aligned(size) : nullptr), size_(size) { }
+
+    void ImageBuffer::reset() noexcept
+    {
+        if (data_)
+        {
+            if (pool_) pool_->release(data_, size_);
+            else free_aligned(data_);
+        }
+        data_ = nullptr;
+        size_ = 0;
+        pool_ = nullptr;
+    }
+
+    ImagePool::~ImagePool()
+    {
+        trim();
+    }
+
+    ImageBuffer ImagePool::acquire(size_t size)
+    {
+        if (size == 0) return ImageBuffer{};
+
+        size_t class_size{};
+        const size_t c = size_class(size, class_size);
+
+        std::unique_lock lock(mutex_);
+        if (free_.size() <= c) free_.resize(c + 1);
+        auto& list = free_[c];
+
+        if (!list.empty())
+        {
+            std::byte* data = list.back();
+            list.pop_back();
+            statistics_.hits++;
+            statistics_.cached_buffers--;
+            statistics_.cached_bytes -= class_size;
+            statistics_.outstanding_buffers++;
+            return ImageBuffer{data, class_size, this};
+        }
+
+        // grow the free list now so that release() never allocates.
+        list.reserve(list.size() + statistics_.outstanding_buffers + 1);
+        std::byte* data = allocate_aligned(class_size);
+        statistics_.misses++;
+        statistics_.outstanding_buffers++;
+        return ImageBuffer{data, class_size, this};
+    }
+
+    void ImagePool::release(std::byte* data, size_t size) noexcept
+    {
+        size_t class_size{};
+        const size_t c = size_class(size, class_size);
+
+        std::unique_lock lock(mutex_);
+        statistics_.outstanding_buffers--;
+        if (statistics_.cached_bytes + class_size > max_cached_bytes_ || free_[c].size() == free_[c].capacity())
+        {
+            statistics_.discards++;
+            lock.unlock();
+            free_aligned(data);
+            return;
+        }
+
+        free_[c].push_back(data);
+        statistics_.cached_buffers++;
+        statistics_.cached_bytes += class_size;
+    }
+
+    void ImagePool::trim() noexcept
+    {
+        std::unique_lock lock(mutex_);
+        for (auto& list : free_)
+        {
+            for (std::byte* data : list) free_aligned(data);
+            list.clear();
+        }
+        statistics_.cached_buffers = 0;
+        statistics_.cached_bytes = 0;
+    }
+
+    ImagePool::Statistics ImagePool::statistics() const noexcept
+    {
+        std::unique_lock lock(mutex_);
+        return statistics_;
+    }
+
+    void ImagePool::reset_statistics() noexcept
+    {
+        std::unique_lock lock(mutex_);
+        statistics_.hits = 0;
+        statistics_.misses = 0;
+        statistics_.discards = 0;
+    }
+}
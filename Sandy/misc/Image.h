@@ -0,0 +1,184 @@
+/// @file
+///	@brief   sandy::Image2d, sandy::ImagePool
+///	@author  (C) 2023 ttsuki
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+#include <stdexcept>
+
+#include "./Span.h"
+
+namespace sandy
+{
+    class ImagePool;
+
+    /// Owning, 64-byte aligned byte block. Blocks acquired from an ImagePool go back to it on destruction.
+    class ImageBuffer final
+    {
+    public:
+        static constexpr size_t alignment = 64;
+
+    private:
+        std::byte* data_{};
+        size_t size_{};
+        ImagePool* pool_{};
+
+        friend class ImagePool;
+        ImageBuffer(std::byte* data, size_t size, ImagePool* pool) noexcept : data_(data), size_(size), pool_(pool) { }
+
+    public:
+        ImageBuffer() = default;
+        explicit ImageBuffer(size_t size);
+        ImageBuffer(const ImageBuffer& other) = delete;
+        ImageBuffer(ImageBuffer&& other) noexcept : data_(std::exchange(other.data_, nullptr)), size_(std::exchange(other.size_, 0)), pool_(std::exchange(other.pool_, nullptr)) { }
+        ImageBuffer& operator=(const ImageBuffer& other) = delete;
+        ImageBuffer& operator=(ImageBuffer&& other) noexcept
+        {
+            if (this != &other)
+            {
+                reset();
+                data_ = std::exchange(other.data_, nullptr);
+                size_ = std::exchange(other.size_, 0);
+                pool_ = std::exchange(other.pool_, nullptr);
+            }
+            return *this;
+        }
+        ~ImageBuffer() { reset(); }
+
+        /// Frees the block, or returns it to its pool.
+        void reset() noexcept;
+
+        [[nodiscard]] std::byte* data() const noexcept { return data_; }
+        [[nodiscard]] size_t size() const noexcept { return size_; } // capacity in bytes, may exceed the requested size
+        [[nodiscard]] bool empty() const noexcept { return data_ == nullptr; }
+    };
+
+    /// Owning 2d image of trivially copyable T. Rows start on 64-byte boundaries; contents are uninitialized.
+    template <class T>
+    class Image2d final
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "Image2d<T> does not construct its elements");
+        static_assert(alignof(T) <= ImageBuffer::alignment);
+
+        ImageBuffer buffer_{};
+        Span2d<T> span_{};
+
+        friend class ImagePool;
+
+        // pitch == 0: width * sizeof(T) rounded up to the alignment.
+        static size_t pitch_for(size_t width, size_t pitch)
+        {
+            const size_t row_bytes = width * sizeof(T);
+            if (pitch == 0) return (row_bytes + ImageBuffer::alignment - 1) & ~(ImageBuffer::alignment - 1);
+            if (pitch < row_bytes) throw std::invalid_argument("pitch");
+            if (pitch % ImageBuffer::alignment != 0) throw std::invalid_argument("pitch must be a multiple of 64");
+            return pitch;
+        }
+
+        Image2d(ImageBuffer buffer, size_t width, size_t height, size_t pitch) noexcept
+            : buffer_(std::move(buffer)), span_{buffer_.data(), width, height, pitch} { }
+
+    public:
+        Image2d() = default;
+
+        /// Allocates width x height elements. pitch (bytes per row) must be 0 (packed) or a multiple of 64 not less than width * sizeof(T).
+        Image2d(size_t width, size_t height, size_t pitch = 0)
+        {
+            pitch = pitch_for(width, pitch);
+            buffer_ = ImageBuffer(pitch * height);
+            span_ = Span2d<T>{buffer_.data(), width, height, pitch};
+        }
+
+        Image2d(const Image2d& other) = delete;
+        Image2d(Image2d&& other) noexcept : buffer_(std::move(other.buffer_)), span_(std::exchange(other.span_, {})) { }
+        Image2d& operator=(const Image2d& other) = delete;
+        Image2d& operator=(Image2d&& other) noexcept
+        {
+            buffer_ = std::move(other.buffer_);
+            span_ = std::exchange(other.span_, {});
+            return *this;
+        }
+        ~Image2d() = default;
+
+        [[nodiscard]] size_t width() const noexcept { return span_.width; }
+        [[nodiscard]] size_t height() const noexcept { return span_.height; }
+        [[nodiscard]] size_t pitch() const noexcept { return span_.width_pitch; }
+        [[nodiscard]] bool empty() const noexcept { return span_.empty(); }
+
+        [[nodiscard]] T* data() noexcept { return static_cast<T*>(span_.pointer); }
+        [[nodiscard]] const T* data() const noexcept { return static_cast<const T*>(span_.pointer); }
+        [[nodiscard]] Span1d<T> row(size_t y) noexcept { return span_.row(y); }
+        [[nodiscard]] Span1d<const T> row(size_t y) const noexcept { return view().row(y); }
+        [[nodiscard]] Span1d<T> operator [](size_t y) noexcept { return row(y); }
+        [[nodiscard]] Span1d<const T> operator [](size_t y) const noexcept { return row(y); }
+
+        [[nodiscard]] Span2d<T> view() noexcept { return span_; }
+        [[nodiscard]] Span2d<const T> view() const noexcept { return Span2d<const T>{span_.pointer, span_.width, span_.height, span_.width_pitch}; }
+        operator Span2d<T>() noexcept { return view(); }
+        operator Span2d<const T>() const noexcept { return view(); }
+
+        /// Releases the storage (back to its pool, if any).
+        void reset() noexcept
+        {
+            buffer_.reset();
+            span_ = {};
+        }
+    };
+
+    /// Thread-safe recycler of ImageBuffers, bucketed by size class (4 classes per power of two, at most 25% slack).
+    /// Once every size in use has been seen, acquire/release hit the free lists and never touch the heap.
+    /// The pool must outlive every buffer acquired from it.
+    class ImagePool final
+    {
+    public:
+        struct Statistics
+        {
+            size_t hits;               // acquires served from a free list
+            size_t misses;             // acquires that allocated
+            size_t discards;           // releases freed because the pool was over max_cached_bytes
+            size_t cached_buffers;     // buffers sitting in free lists
+            size_t cached_bytes;
+            size_t outstanding_buffers; // buffers acquired and not yet released
+        };
+
+    private:
+        mutable std::mutex mutex_{};
+        const size_t max_cached_bytes_{};
+        std::vector<std::vector<std::byte*>> free_{}; // [size class]
+        Statistics statistics_{};
+
+        friend class ImageBuffer;
+        void release(std::byte* data, size_t size) noexcept;
+
+    public:
+        explicit ImagePool(size_t max_cached_bytes = SIZE_MAX) : max_cached_bytes_(max_cached_bytes) { }
+        ImagePool(const ImagePool& other) = delete;
+        ImagePool(ImagePool&& other) noexcept = delete;
+        ImagePool& operator=(const ImagePool& other) = delete;
+        ImagePool& operator=(ImagePool&& other) noexcept = delete;
+        ~ImagePool();
+
+        /// Returns a buffer of at least size bytes.
+        [[nodiscard]] ImageBuffer acquire(size_t size);
+
+        /// Returns an image whose storage comes from this pool; see Image2d(width, height, pitch).
+        template <class T>
+        [[nodiscard]] Image2d<T> acquire(size_t width, size_t height, size_t pitch = 0)
+        {
+            pitch = Image2d<T>::pitch_for(width, pitch);
+            return Image2d<T>(acquire(pitch * height), width, height, pitch);
+        }
+
+        /// Frees every cached buffer.
+        void trim() noexcept;
+
+        [[nodiscard]] Statistics statistics() const noexcept;
+        void reset_statistics() noexcept; // clears hits, misses and discards
+    };
+}
@@ -0,0 +1,246 @@
+/// @file
+///	@brief   sandy image operations
+///	@author  (C) 2023 ttsuki
+
+#include "./ImageOps.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "./ark/xmm.h"
+
+namespace sandy
+{
+    // Calls row(src_row, dst_row, width) over the common extent; spans without row padding are passed as a single row.
+    template <class S, class D, class Row>
+    static void for_each_row(Span2d<S> src, Span2d<D> dst, Row&& row) noexcept
+    {
+        const size_t width = std::min(src.width, dst.width);
+        const size_t height = std::min(src.height, dst.height);
+        if (width == 0 || height == 0) return;
+
+        if (src.width_pitch == width * sizeof(S) && dst.width_pitch == width * sizeof(D))
+            return row(static_cast<S*>(src.pointer), static_cast<D*>(dst.pointer), width * height);
+
+        for (size_t y = 0; y < height; y++)
+            row(src.row(y).data(), dst.row(y).data(), width);
+    }
+
+    template <class D, class Row>
+    static void for_each_row(Span2d<D> dst, Row&& row) noexcept
+    {
+        for_each_row(dst, dst, [&row](D*, D* d, size_t n) { row(d, n); });
+    }
+
+    // x / 255 rounded, for x in [0, 255 * 255]
+    static constexpr uint32_t div255(uint32_t x) noexcept
+    {
+        x += 128;
+        return (x + (x >> 8)) >> 8;
+    }
+
+    static constexpr uint32_t blend_over(uint32_t s, uint32_t d) noexcept
+    {
+        const uint32_t ia = 255 - (s >> 24);
+        uint32_t r = 0;
+        for (int shift = 0; shift < 32; shift += 8)
+            r |= std::min<uint32_t>((s >> shift & 0xFF) + div255((d >> shift & 0xFF) * ia), 255) << shift;
+        return r;
+    }
+
+    static constexpr uint32_t premultiply(uint32_t s) noexcept
+    {
+        const uint32_t a = s >> 24;
+        return a << 24 | div255((s >> 16 & 0xFF) * a) << 16 | div255((s >> 8 & 0xFF) * a) << 8 | div255((s & 0xFF) * a);
+    }
+
+    static constexpr uint32_t swizzle(uint32_t s, int p0, int p1, int p2, int p3) noexcept
+    {
+        return (s >> 8 * p0 & 0xFF) | (s >> 8 * p1 & 0xFF) << 8 | (s >> 8 * p2 & 0xFF) << 16 | (s >> 8 * p3 & 0xFF) << 24;
+    }
+
+#if defined(__AVX2__)
+    // pshufb control placing the 16-bit alpha of pixels {0, 1} (hi = false) or {2, 3} (hi = true) of each 128-bit lane in all 4 channels,
+    // matching unpack8_lo/hi(pixels, zero). alpha_channel = false zeroes the alpha channel's own multiplier.
+    static arkxmm::vi8x32 alpha_control(bool hi, bool alpha_channel) noexcept
+    {
+        alignas(32) int8_t c[32];
+        for (int i = 0; i < 32; i += 2)
+        {
+            const int pixel = (i % 16) / 8 + (hi ? 2 : 0);
+            const bool alpha = (i % 8) == 6;
+            c[i] = static_cast<int8_t>(alpha && !alpha_channel ? 0x80 : 4 * pixel + 3);
+            c[i + 1] = static_cast<int8_t>(0x80);
+        }
+        return arkxmm::load_a<arkxmm::vi8x32>(c);
+    }
+
+    // x * m / 255 rounded, for 16-bit x, m <= 255
+    static arkxmm::vu16x16 mul_div255(arkxmm::vu16x16 x, arkxmm::vu16x16 m) noexcept
+    {
+        using namespace arkxmm;
+        return mul_hi(x * m + u16x16(128), u16x16(257));
+    }
+#endif
+
+    void fill(Span2d<uint32_t> dst, uint32_t value) noexcept
+    {
+        for_each_row(dst, [value](uint32_t* d, size_t n)
+        {
+            size_t i = 0;
+#if defined(__AVX2__)
+            const arkxmm::vu32x8 v = arkxmm::u32x8(value);
+            for (; i + 8 <= n; i += 8)
+                arkxmm::store_u<arkxmm::vu32x8>(d + i, v);
+#endif
+            std::fill(d + i, d + n, value);
+        });
+    }
+
+    void fill(Span2d<uint8_t> dst, uint8_t value) noexcept
+    {
+        for_each_row(dst, [value](uint8_t* d, size_t n) { std::memset(d, value, n); });
+    }
+
+    void copy(Span2d<const uint32_t> src, Span2d<uint32_t> dst) noexcept
+    {
+        for_each_row(src, dst, [](const uint32_t* s, uint32_t* d, size_t n) { std::memmove(d, s, n * sizeof(uint32_t)); });
+    }
+
+    void copy(Span2d<const uint8_t> src, Span2d<uint8_t> dst) noexcept
+    {
+        for_each_row(src, dst, [](const uint8_t* s, uint8_t* d, size_t n) { std::memmove(d, s, n); });
+    }
+
+    void blend_over(Span2d<const uint32_t> src, Span2d<uint32_t> dst) noexcept
+    {
+#if defined(__AVX2__)
+        using namespace arkxmm;
+        const vi8x32 lo_control = alpha_control(false, true);
+        const vi8x32 hi_control = alpha_control(true, true);
+#endif
+        for_each_row(src, dst, [&](const uint32_t* s, uint32_t* d, size_t n)
+        {
+            size_t i = 0;
+#if defined(__AVX2__)
+            for (; i + 8 <= n; i += 8)
+            {
+                const vu8x32 sv = load_u<vu8x32>(s + i);
+                const vu8x32 dv = load_u<vu8x32>(d + i);
+                const vu8x32 ia = ~sv;
+                const vu16x16 lo = mul_div255(reinterpret<vu16x16>(unpack8_lo(dv, zero<vu8x32>())), reinterpret<vu16x16>(byte_shuffle_128(ia, lo_control)));
+                const vu16x16 hi = mul_div255(reinterpret<vu16x16>(unpack8_hi(dv, zero<vu8x32>())), reinterpret<vu16x16>(byte_shuffle_128(ia, hi_control)));
+                store_u<vu8x32>(d + i, add_sat(sv, pack_sat_u(reinterpret<vi16x16>(lo), reinterpret<vi16x16>(hi))));
+            }
+#endif
+            for (; i < n; i++)
+                d[i] = blend_over(s[i], d[i]);
+        });
+    }
+
+    void premultiply(Span2d<const uint32_t> src, Span2d<uint32_t> dst) noexcept
+    {
+#if defined(__AVX2__)
+        using namespace arkxmm;
+        const vi8x32 lo_control = alpha_control(false, false);
+        const vi8x32 hi_control = alpha_control(true, false);
+        const vu16x16 keep_alpha = u16x16(0, 0, 0, 255, 0, 0, 0, 255, 0, 0, 0, 255, 0, 0, 0, 255); // multiplier 255 for the alpha channel
+#endif
+        for_each_row(src, dst, [&](const uint32_t* s, uint32_t* d, size_t n)
+        {
+            size_t i = 0;
+#if defined(__AVX2__)
+            for (; i + 8 <= n; i += 8)
+            {
+                const vu8x32 sv = load_u<vu8x32>(s + i);
+                const vu16x16 lo = mul_div255(reinterpret<vu16x16>(unpack8_lo(sv, zero<vu8x32>())), reinterpret<vu16x16>(byte_shuffle_128(sv, lo_control)) | keep_alpha);
+                const vu16x16 hi = mul_div255(reinterpret<vu16x16>(unpack8_hi(sv, zero<vu8x32>())), reinterpret<vu16x16>(byte_shuffle_128(sv, hi_control)) | keep_alpha);
+                store_u<vu8x32>(d + i, pack_sat_u(reinterpret<vi16x16>(lo), reinterpret<vi16x16>(hi)));
+            }
+#endif
+            for (; i < n; i++)
+                d[i] = premultiply(s[i]);
+        });
+    }
+
+    void expand_alpha(Span2d<const uint8_t> src, Span2d<uint32_t> dst, uint32_t rgb) noexcept
+    {
+        rgb &= 0x00FFFFFF;
+        for_each_row(src, dst, [rgb](const uint8_t* s, uint32_t* d, size_t n)
+        {
+            size_t i = 0;
+#if defined(__AVX2__)
+            using namespace arkxmm;
+            const vu32x8 color = u32x8(rgb);
+            for (; i + 32 <= n; i += 32)
+            {
+                const vu8x32 a = load_u<vu8x32>(s + i);
+                store_u<vu32x8>(d + i + 0, convert_cast<vu32x8>(lower128(a)) << 24 | color);
+                store_u<vu32x8>(d + i + 8, convert_cast<vu32x8>(byte_shift_r_128<8>(lower128(a))) << 24 | color);
+                store_u<vu32x8>(d + i + 16, convert_cast<vu32x8>(higher128(a)) << 24 | color);
+                store_u<vu32x8>(d + i + 24, convert_cast<vu32x8>(byte_shift_r_128<8>(higher128(a))) << 24 | color);
+            }
+#endif
+            for (; i < n; i++)
+                d[i] = static_cast<uint32_t>(s[i]) << 24 | rgb;
+        });
+    }
+
+    void expand_alpha(Span2d<const uint32_t> src, Span2d<uint32_t> dst, uint32_t rgb) noexcept
+    {
+        rgb &= 0x00FFFFFF;
+        for_each_row(src, dst, [rgb](const uint32_t* s, uint32_t* d, size_t n)
+        {
+            size_t i = 0;
+#if defined(__AVX2__)
+            using namespace arkxmm;
+            const vu32x8 mask = u32x8(0xFF000000u);
+            const vu32x8 color = u32x8(rgb);
+            for (; i + 8 <= n; i += 8)
+                store_u<vu32x8>(d + i, (load_u<vu32x8>(s + i) & mask) | color);
+#endif
+            for (; i < n; i++)
+                d[i] = (s[i] & 0xFF000000u) | rgb;
+        });
+    }
+
+    void extract_alpha(Span2d<const uint32_t> src, Span2d<uint8_t> dst) noexcept
+    {
+        for_each_row(src, dst, [](const uint32_t* s, uint8_t* d, size_t n)
+        {
+            size_t i = 0;
+#if defined(__AVX2__)
+            using namespace arkxmm;
+            for (; i + 32 <= n; i += 32)
+            {
+                auto alpha = [s, i](size_t k) { return reinterpret<vi32x8>(load_u<vu32x8>(s + i + k) >> 24); };
+                // {a0,a2|a1,a3}, {a4,a6|a5,a7} as 16-bit, then {a0,a2,a4,a6|a1,a3,a5,a7} as 8-bit.
+                const vi16x16 a01 = pack_sat_i(alpha(0), alpha(8));
+                const vi16x16 a23 = pack_sat_i(alpha(16), alpha(24));
+                store_u<vu8x32>(d + i, permute32<0, 4, 1, 5, 2, 6, 3, 7>(pack_sat_u(a01, a23)));
+            }
+#endif
+            for (; i < n; i++)
+                d[i] = static_cast<uint8_t>(s[i] >> 24);
+        });
+    }
+
+    void swizzle(Span2d<const uint32_t> src, Span2d<uint32_t> dst, int p0, int p1, int p2, int p3) noexcept
+    {
+#if defined(__AVX2__)
+        using namespace arkxmm;
+        auto e = [=](int k) { return (4 * k + p0) | (4 * k + p1) << 8 | (4 * k + p2) << 16 | (4 * k + p3) << 24; };
+        const vi8x32 control = reinterpret<vi8x32>(i32x8(e(0), e(1), e(2), e(3), e(0), e(1), e(2), e(3)));
+#endif
+        for_each_row(src, dst, [&](const uint32_t* s, uint32_t* d, size_t n)
+        {
+            size_t i = 0;
+#if defined(__AVX2__)
+            for (; i + 8 <= n; i += 8)
+                store_u<vu8x32>(d + i, byte_shuffle_128(load_u<vu8x32>(s + i), control));
+#endif
+            for (; i < n; i++)
+                d[i] = swizzle(s[i], p0, p1, p2, p3);
+        });
+    }
+}
@@ -0,0 +1,43 @@
+/// @file
+///	@brief   sandy image operations
+///	@author  (C) 2023 ttsuki
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "./Span.h"
+
+namespace sandy
+{
+    // Pixel kernels over Span2d rows, 32 bytes per iteration with AVX2 and a per-pixel scalar path otherwise (and for row tails).
+    // 32-bit pixels are 8-bit 4-channel with alpha in the top byte (0xAARRGGBB, i.e. B8G8R8A8 / R8G8B8A8 in memory);
+    // only premultiply and blend_over look at which byte is alpha, the other channels are treated alike.
+    // Two-span operations process the common extent min(src, dst) and accept src == dst for in-place use.
+
+    void fill(Span2d<uint32_t> dst, uint32_t value) noexcept;
+    void fill(Span2d<uint8_t> dst, uint8_t value) noexcept;
+
+    /// Copies between spans of any pitch.
+    void copy(Span2d<const uint32_t> src, Span2d<uint32_t> dst) noexcept;
+    void copy(Span2d<const uint8_t> src, Span2d<uint8_t> dst) noexcept;
+
+    /// Porter-Duff source-over of premultiplied pixels: dst = src + dst * (255 - src.a) / 255, rounded.
+    void blend_over(Span2d<const uint32_t> src, Span2d<uint32_t> dst) noexcept;
+
+    /// dst.rgb = src.rgb * src.a / 255 rounded, dst.a = src.a.
+    void premultiply(Span2d<const uint32_t> src, Span2d<uint32_t> dst) noexcept;
+
+    /// A8 to 32-bit: dst = src << 24 | rgb, e.g. glyph coverage to a straight-alpha color.
+    void expand_alpha(Span2d<const uint8_t> src, Span2d<uint32_t> dst, uint32_t rgb = 0x00FFFFFF) noexcept;
+
+    /// Keeps the alpha of 32-bit src and replaces the color: dst = (src & 0xFF000000) | rgb.
+    void expand_alpha(Span2d<const uint32_t> src, Span2d<uint32_t> dst, uint32_t rgb = 0x00FFFFFF) noexcept;
+
+    /// 32-bit to A8: dst = src >> 24.
+    void extract_alpha(Span2d<const uint32_t> src, Span2d<uint8_t> dst) noexcept;
+
+    /// Byte k (0 = lowest) of each dst pixel = byte pk of the src pixel; e.g. (2, 1, 0, 3) swaps BGRA <-> RGBA.
+    void swizzle(Span2d<const uint32_t> src, Span2d<uint32_t> dst, int p0, int p1, int p2, int p3) noexcept;
+}
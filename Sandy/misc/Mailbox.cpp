@@ -0,0 +1,5 @@
+/// @file
+///	@brief   sandy::Mailbox
+///	@author  (C) 2023 ttsuki
+
+#include "./Mailbox.h"
@@ -0,0 +1,92 @@
+/// @file
+///	@brief   sandy::Mailbox
+///	@author  (C) 2023 ttsuki
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <atomic>
+#include <optional>
+#include <utility>
+
+namespace sandy
+{
+    /// Wait-free single-producer/single-consumer latest-value slot (triple buffer).
+    /// The producer fills back() and publish()es it; the consumer's update() swaps in the newest published value,
+    /// skipping any it missed. Three slots let each side own one while the third carries the latest publish,
+    /// so neither side ever waits for the other: each call is one atomic exchange.
+    template <class T>
+    class Mailbox final
+    {
+        static constexpr uint8_t index_mask = 3;
+        static constexpr uint8_t fresh_bit = 4;
+        static constexpr size_t cache_line = 64;
+
+        struct alignas(cache_line) Slot
+        {
+            T value{};
+        };
+
+        Slot slots_[3]{};
+
+        // index of the slot between producer and consumer, | fresh_bit while it holds a value the consumer has not seen.
+        alignas(cache_line) std::atomic<uint8_t> middle_{1};
+        alignas(cache_line) uint8_t back_{0};  // producer's slot
+        alignas(cache_line) uint8_t front_{2}; // consumer's slot
+
+    public:
+        Mailbox() = default;
+        Mailbox(const Mailbox& other) = delete;
+        Mailbox(Mailbox&& other) noexcept = delete;
+        Mailbox& operator=(const Mailbox& other) = delete;
+        Mailbox& operator=(Mailbox&& other) noexcept = delete;
+        ~Mailbox() = default;
+
+        /// Producer: slot to fill before publish(). It may hold an older value that was never read.
+        [[nodiscard]] T& back() noexcept
+        {
+            return slots_[back_].value;
+        }
+
+        /// Producer: makes back() the newest value and takes over the slot it replaces.
+        void publish() noexcept
+        {
+            back_ = middle_.exchange(static_cast<uint8_t>(back_ | fresh_bit), std::memory_order_acq_rel) & index_mask;
+        }
+
+        template <class U>
+        void publish(U&& value)
+        {
+            back() = std::forward<U>(value);
+            publish();
+        }
+
+        /// True if a value was published since the consumer's last update().
+        [[nodiscard]] bool fresh() const noexcept
+        {
+            return middle_.load(std::memory_order_acquire) & fresh_bit;
+        }
+
+        /// Consumer: makes the newest published value front(). Returns false, keeping front(), if there is nothing new.
+        bool update() noexcept
+        {
+            if (!fresh()) { return false; }
+            front_ = middle_.exchange(front_, std::memory_order_acq_rel) & index_mask;
+            return true;
+        }
+
+        /// Consumer: value of the last update().
+        [[nodiscard]] T& front() noexcept
+        {
+            return slots_[front_].value;
+        }
+
+        /// Consumer: moves out the newest value if there is one since the last take or update.
+        [[nodiscard]] std::optional<T> take()
+        {
+            if (!update()) { return std::nullopt; }
+            return std::optional<T>(std::move(front()));
+        }
+    };
+}
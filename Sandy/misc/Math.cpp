@@ -3,3 +3,594 @@
 ///	@author  (C) 2023 ttsuki
 
 #include "./Math.h"
+
+#include <cstddef>
+
+namespace sandy
+{
+    // Transforms 2 points {p0|p1} by m, where m0..m3 are rows broadcast to both lanes.
+    template <size_t N>
+    ARKXMM_API transform_points_x2(arkxmm::vf32x8 p, arkxmm::vf32x8 m0, arkxmm::vf32x8 m1, arkxmm::vf32x8 m2, arkxmm::vf32x8 m3) noexcept -> arkxmm::vf32x8
+    {
+        using namespace arkxmm;
+        if constexpr (N == 2) return shuffle<0, 0, 0, 0>(p) * m0 + shuffle<1, 1, 1, 1>(p) * m1 + m3;
+        if constexpr (N == 3) return shuffle<0, 0, 0, 0>(p) * m0 + shuffle<1, 1, 1, 1>(p) * m1 + shuffle<2, 2, 2, 2>(p) * m2 + m3;
+        if constexpr (N == 4) return shuffle<0, 0, 0, 0>(p) * m0 + shuffle<1, 1, 1, 1>(p) * m1 + shuffle<2, 2, 2, 2>(p) * m2 + shuffle<3, 3, 3, 3>(p) * m3;
+    }
+
+    // dst[i] = src[i] * m, for N-component source points. (z, w) defaults to (0, 1).
+    // Each 256-bit register carries 2 points; a full 8x4 transpose to SoA costs more shuffles than
+    // the in-lane broadcasts it saves, so points stay AoS and only the matrix rows are duplicated.
+    template <size_t N>
+    static void transform_points_kernel(
+        const Matrix4x4& m,
+        const std::byte* src, size_t src_stride,
+        std::byte* dst, size_t dst_stride,
+        size_t count) noexcept
+    {
+        using namespace arkxmm;
+
+        const vf32x8 m0 = f32x8(m.m0, m.m0);
+        const vf32x8 m1 = f32x8(m.m1, m.m1);
+        const vf32x8 m2 = f32x8(m.m2, m.m2);
+        const vf32x8 m3 = f32x8(m.m3, m.m3);
+
+        auto load = [src_stride](const std::byte* s, size_t i)
+        {
+            if (src_stride == sizeof(vf32x4)) return load_u<vf32x8>(s + src_stride * i);
+            return f32x8(load_u<vf32x4>(s + src_stride * i), load_u<vf32x4>(s + src_stride * (i + 1)));
+        };
+
+        auto store = [dst_stride](std::byte* d, size_t i, vf32x8 v)
+        {
+            if (dst_stride == sizeof(vf32x4)) return static_cast<void>(store_u<vf32x8>(d + dst_stride * i, v));
+            store_u<vf32x4>(d + dst_stride * i, lower128(v));
+            store_u<vf32x4>(d + dst_stride * (i + 1), higher128(v));
+        };
+
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8)
+        {
+            const std::byte* s = src + src_stride * i;
+            std::byte* d = dst + dst_stride * i;
+
+            // all loads before stores, so src and dst may alias.
+            vf32x8 p01 = load(s, 0);
+            vf32x8 p23 = load(s, 2);
+            vf32x8 p45 = load(s, 4);
+            vf32x8 p67 = load(s, 6);
+            store(d, 0, transform_points_x2<N>(p01, m0, m1, m2, m3));
+            store(d, 2, transform_points_x2<N>(p23, m0, m1, m2, m3));
+            store(d, 4, transform_points_x2<N>(p45, m0, m1, m2, m3));
+            store(d, 6, transform_points_x2<N>(p67, m0, m1, m2, m3));
+        }
+
+        for (; i < count; i++)
+        {
+            auto p = load_u<vf32x4>(src + src_stride * i);
+            PositionVector q;
+            if constexpr (N == 2) q = transform(Vec2{p}, m);
+            if constexpr (N == 3) q = transform(Vec3{p}, m);
+            if constexpr (N == 4) q = transform(PositionVector{p}, m);
+            store_u<vf32x4>(dst + dst_stride * i, q.v);
+        }
+    }
+
+    void transform_points(const Matrix4x4& m, const Vec2 src[], PositionVector dst[], size_t count) noexcept
+    {
+        return transform_points_kernel<2>(m, reinterpret_cast<const std::byte*>(src), sizeof(Vec2), reinterpret_cast<std::byte*>(dst), sizeof(PositionVector), count);
+    }
+
+    void transform_points(const Matrix4x4& m, const Vec3 src[], PositionVector dst[], size_t count) noexcept
+    {
+        return transform_points_kernel<3>(m, reinterpret_cast<const std::byte*>(src), sizeof(Vec3), reinterpret_cast<std::byte*>(dst), sizeof(PositionVector), count);
+    }
+
+    void transform_points(const Matrix4x4& m, const PositionVector src[], PositionVector dst[], size_t count) noexcept
+    {
+        return transform_points_kernel<4>(m, reinterpret_cast<const std::byte*>(src), sizeof(PositionVector), reinterpret_cast<std::byte*>(dst), sizeof(PositionVector), count);
+    }
+
+    void transform_points(const Matrix4x4& m, const PositionVector* src, size_t src_stride, PositionVector* dst, size_t dst_stride, size_t count) noexcept
+    {
+        return transform_points_kernel<4>(m, reinterpret_cast<const std::byte*>(src), src_stride, reinterpret_cast<std::byte*>(dst), dst_stride, count);
+    }
+
+    // dst[i] = kernel(src[i]), 2 matrices per 256-bit register.
+    template <class Kernel>
+    static void matrix_batch(const Matrix4x4 src[], Matrix4x4 dst[], size_t count, Kernel&& kernel) noexcept
+    {
+        using namespace arkxmm;
+
+        size_t i = 0;
+        for (; i + 2 <= count; i += 2)
+        {
+            vf32x8 m0 = f32x8(src[i].m0, src[i + 1].m0);
+            vf32x8 m1 = f32x8(src[i].m1, src[i + 1].m1);
+            vf32x8 m2 = f32x8(src[i].m2, src[i + 1].m2);
+            vf32x8 m3 = f32x8(src[i].m3, src[i + 1].m3);
+            kernel(m0, m1, m2, m3);
+            dst[i] = Matrix4x4{lower128(m0), lower128(m1), lower128(m2), lower128(m3)};
+            dst[i + 1] = Matrix4x4{higher128(m0), higher128(m1), higher128(m2), higher128(m3)};
+        }
+
+        for (; i < count; i++)
+        {
+            Matrix4x4 m = src[i];
+            kernel(m.m0, m.m1, m.m2, m.m3);
+            dst[i] = m;
+        }
+    }
+
+    void inverse(const Matrix4x4 src[], Matrix4x4 dst[], size_t count) noexcept
+    {
+        return matrix_batch(src, dst, count, [](auto& m0, auto& m1, auto& m2, auto& m3) { detail::inverse_4x4(m0, m1, m2, m3); });
+    }
+
+    void inverse_affine(const Matrix4x4 src[], Matrix4x4 dst[], size_t count) noexcept
+    {
+        return matrix_batch(src, dst, count, [](auto& m0, auto& m1, auto& m2, auto& m3) { detail::inverse_affine_4x4(m0, m1, m2, m3); });
+    }
+
+    void inverse_orthonormal(const Matrix4x4 src[], Matrix4x4 dst[], size_t count) noexcept
+    {
+        return matrix_batch(src, dst, count, [](auto& m0, auto& m1, auto& m2, auto& m3) { detail::inverse_orthonormal_4x4(m0, m1, m2, m3); });
+    }
+
+    void multiply(const Matrix4x4 a[], const Matrix4x4& b, Matrix4x4 dst[], size_t count) noexcept
+    {
+        return matrix_batch(a, dst, count, [b](auto& m0, auto& m1, auto& m2, auto& m3)
+        {
+            using V = std::decay_t<decltype(m0)>;
+            const V b0 = detail::lanes<V>(b.m0), b1 = detail::lanes<V>(b.m1), b2 = detail::lanes<V>(b.m2), b3 = detail::lanes<V>(b.m3);
+            m0 = detail::multiply_row(m0, b0, b1, b2, b3);
+            m1 = detail::multiply_row(m1, b0, b1, b2, b3);
+            m2 = detail::multiply_row(m2, b0, b1, b2, b3);
+            m3 = detail::multiply_row(m3, b0, b1, b2, b3);
+        });
+    }
+
+    void multiply_transpose(const Matrix4x4 a[], const Matrix4x4& b, Matrix4x4 dst[], size_t count) noexcept
+    {
+        return matrix_batch(a, dst, count, [b](auto& m0, auto& m1, auto& m2, auto& m3)
+        {
+            using V = std::decay_t<decltype(m0)>;
+            const V b0 = detail::lanes<V>(b.m0), b1 = detail::lanes<V>(b.m1), b2 = detail::lanes<V>(b.m2), b3 = detail::lanes<V>(b.m3);
+            m0 = detail::multiply_row(m0, b0, b1, b2, b3);
+            m1 = detail::multiply_row(m1, b0, b1, b2, b3);
+            m2 = detail::multiply_row(m2, b0, b1, b2, b3);
+            m3 = detail::multiply_row(m3, b0, b1, b2, b3);
+            arkxmm::transpose_32x4x4(m0, m1, m2, m3);
+        });
+    }
+
+    void transpose(const Matrix4x4 src[], Matrix4x4 dst[], size_t count) noexcept
+    {
+        // 128-bit transposes: shuffle bound either way, and measured faster than 2 matrices per register.
+        for (size_t i = 0; i < count; i++)
+            dst[i] = transpose(src[i]);
+    }
+
+    // 8 AoS elements {x,y,z,w} <-> SoA {x0..x7}, {y0..y7}, {z0..z7}, {w0..w7}
+    ARKXMM_API load_soa_x8(const arkxmm::vf32x4 p[8], arkxmm::vf32x8& x, arkxmm::vf32x8& y, arkxmm::vf32x8& z, arkxmm::vf32x8& w) noexcept -> void
+    {
+        using namespace arkxmm;
+        x = f32x8(p[0], p[4]);
+        y = f32x8(p[1], p[5]);
+        z = f32x8(p[2], p[6]);
+        w = f32x8(p[3], p[7]);
+        transpose_32x4x4(x, y, z, w);
+    }
+
+    ARKXMM_API store_soa_x8(arkxmm::vf32x4 p[8], arkxmm::vf32x8 x, arkxmm::vf32x8 y, arkxmm::vf32x8 z, arkxmm::vf32x8 w) noexcept -> void
+    {
+        using namespace arkxmm;
+        transpose_32x4x4(x, y, z, w);
+        p[0] = lower128(x);
+        p[1] = lower128(y);
+        p[2] = lower128(z);
+        p[3] = lower128(w);
+        p[4] = higher128(x);
+        p[5] = higher128(y);
+        p[6] = higher128(z);
+        p[7] = higher128(w);
+    }
+
+    // sin(x) for x in [0, pi/2], |error| < 1e-7
+    ARKXMM_API sin_0_half_pi(arkxmm::vf32x8 x) noexcept -> arkxmm::vf32x8
+    {
+        using namespace arkxmm;
+        vf32x8 x2 = x * x;
+        vf32x8 p = f32x8(-1.0f / 39916800.0f);
+        p = p * x2 + f32x8(1.0f / 362880.0f);
+        p = p * x2 + f32x8(-1.0f / 5040.0f);
+        p = p * x2 + f32x8(1.0f / 120.0f);
+        p = p * x2 + f32x8(-1.0f / 6.0f);
+        p = p * x2 + f32x8(1.0f);
+        return p * x;
+    }
+
+    // acos(x) for x in [0, 1], |error| < 1e-7 (Abramowitz and Stegun 4.4.46)
+    ARKXMM_API acos_0_1(arkxmm::vf32x8 x) noexcept -> arkxmm::vf32x8
+    {
+        using namespace arkxmm;
+        vf32x8 p = f32x8(-0.0012624911f);
+        p = p * x + f32x8(0.0066700901f);
+        p = p * x + f32x8(-0.0170881256f);
+        p = p * x + f32x8(0.0308918810f);
+        p = p * x + f32x8(-0.0501743046f);
+        p = p * x + f32x8(0.0889789874f);
+        p = p * x + f32x8(-0.2145988016f);
+        p = p * x + f32x8(1.5707963050f);
+        return p * sqrt(f32x8(1.0f) - x);
+    }
+
+    // Quaternion SoA interpolation, Weights(d, t, &wa, &wb) with d = |dot(a, b)|.
+    template <class Weights, class Scalar>
+    static void interpolate_quaternions(const Quaternion a[], const Quaternion b[], const float t[], Quaternion dst[], size_t count, Weights&& weights, Scalar&& scalar) noexcept
+    {
+        using namespace arkxmm;
+
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8)
+        {
+            vf32x8 ax, ay, az, aw, bx, by, bz, bw;
+            load_soa_x8(&a[i].v, ax, ay, az, aw);
+            load_soa_x8(&b[i].v, bx, by, bz, bw);
+            vf32x8 tt = load_u<vf32x8>(t + i);
+
+            // shortest path: negate b where dot(a, b) < 0
+            vf32x8 d = ax * bx + ay * by + az * bz + aw * bw;
+            vf32x8 sign = d & f32x8(-0.0f);
+            bx = bx ^ sign;
+            by = by ^ sign;
+            bz = bz ^ sign;
+            bw = bw ^ sign;
+
+            vf32x8 wa, wb;
+            weights(d ^ sign, tt, wa, wb);
+            vf32x8 rx = ax * wa + bx * wb;
+            vf32x8 ry = ay * wa + by * wb;
+            vf32x8 rz = az * wa + bz * wb;
+            vf32x8 rw = aw * wa + bw * wb;
+
+            vf32x8 rcp_len = f32x8(1.0f) / sqrt(rx * rx + ry * ry + rz * rz + rw * rw);
+            store_soa_x8(&dst[i].v, rx * rcp_len, ry * rcp_len, rz * rcp_len, rw * rcp_len);
+        }
+
+        for (; i < count; i++)
+            dst[i] = scalar(a[i], b[i], t[i]);
+    }
+
+    void nlerp(const Quaternion a[], const Quaternion b[], const float t[], Quaternion dst[], size_t count) noexcept
+    {
+        return interpolate_quaternions(a, b, t, dst, count, [](arkxmm::vf32x8, arkxmm::vf32x8 t, arkxmm::vf32x8& wa, arkxmm::vf32x8& wb)
+        {
+            wa = arkxmm::f32x8(1.0f) - t;
+            wb = t;
+        }, [](Quaternion a, Quaternion b, float t) { return nlerp(a, b, t); });
+    }
+
+    void slerp(const Quaternion a[], const Quaternion b[], const float t[], Quaternion dst[], size_t count) noexcept
+    {
+        return interpolate_quaternions(a, b, t, dst, count, [](arkxmm::vf32x8 d, arkxmm::vf32x8 t, arkxmm::vf32x8& wa, arkxmm::vf32x8& wb)
+        {
+            using namespace arkxmm;
+            vf32x8 theta = acos_0_1(min(d, f32x8(1.0f)));
+            vf32x8 linear = d > f32x8(0.9995f); // nearly parallel: nlerp
+            wa = blend(sin_0_half_pi((f32x8(1.0f) - t) * theta), f32x8(1.0f) - t, linear);
+            wb = blend(sin_0_half_pi(t * theta), t, linear);
+        }, [](Quaternion a, Quaternion b, float t) { return slerp(a, b, t); });
+    }
+
+    void scale_rotate_translate(const Vec3 scale[], const Quaternion rotation[], const Vec3 translate[], Matrix4x4 dst[], size_t count) noexcept
+    {
+        using namespace arkxmm;
+
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8)
+        {
+            vf32x8 x, y, z, w, sx, sy, sz, _;
+            load_soa_x8(&rotation[i].v, x, y, z, w);
+            load_soa_x8(&scale[i].v, sx, sy, sz, _);
+
+            vf32x8 one = f32x8(1.0f);
+            vf32x8 x2 = x + x, y2 = y + y, z2 = z + z;
+            vf32x8 xx = x * x2, yy = y * y2, zz = z * z2;
+            vf32x8 xy = x * y2, xz = x * z2, yz = y * z2;
+            vf32x8 wx = w * x2, wy = w * y2, wz = w * z2;
+
+            // SoA rows {m0..m3|m4..m7} -> AoS rows {matrix k|matrix k+4}
+            vf32x8 a0 = (one - (yy + zz)) * sx, a1 = (xy + wz) * sx, a2 = (xz - wy) * sx, a3 = zero<vf32x8>();
+            vf32x8 b0 = (xy - wz) * sy, b1 = (one - (xx + zz)) * sy, b2 = (yz + wx) * sy, b3 = zero<vf32x8>();
+            vf32x8 c0 = (xz + wy) * sz, c1 = (yz - wx) * sz, c2 = (one - (xx + yy)) * sz, c3 = zero<vf32x8>();
+            transpose_32x4x4(a0, a1, a2, a3);
+            transpose_32x4x4(b0, b1, b2, b3);
+            transpose_32x4x4(c0, c1, c2, c3);
+
+            Matrix4x4* d = dst + i;
+            const Vec3* t = translate + i;
+            d[0] = Matrix4x4{lower128(a0), lower128(b0), lower128(c0), PositionVector(t[0]).v};
+            d[1] = Matrix4x4{lower128(a1), lower128(b1), lower128(c1), PositionVector(t[1]).v};
+            d[2] = Matrix4x4{lower128(a2), lower128(b2), lower128(c2), PositionVector(t[2]).v};
+            d[3] = Matrix4x4{lower128(a3), lower128(b3), lower128(c3), PositionVector(t[3]).v};
+            d[4] = Matrix4x4{higher128(a0), higher128(b0), higher128(c0), PositionVector(t[4]).v};
+            d[5] = Matrix4x4{higher128(a1), higher128(b1), higher128(c1), PositionVector(t[5]).v};
+            d[6] = Matrix4x4{higher128(a2), higher128(b2), higher128(c2), PositionVector(t[6]).v};
+            d[7] = Matrix4x4{higher128(a3), higher128(b3), higher128(c3), PositionVector(t[7]).v};
+        }
+
+        for (; i < count; i++)
+            dst[i] = matrix4x4::ScaleRotateTranslate(scale[i], rotation[i], translate[i]);
+    }
+
+    // Runs Kernel(linear, translation, &linear, &translation) over Affine2D arrays, 2 transforms per 256-bit register.
+    template <class Kernel>
+    static void affine2d_batch(const Affine2D src[], Affine2D dst[], size_t count, Kernel&& kernel) noexcept
+    {
+        using namespace arkxmm;
+
+        size_t i = 0;
+        for (; i + 2 <= count; i += 2)
+        {
+            vf32x8 l = f32x8(src[i].linear(), src[i + 1].linear());
+            vf32x8 t = f32x8(src[i].translation(), src[i + 1].translation());
+            vf32x8 rl, rt;
+            kernel(l, t, rl, rt);
+            dst[i].store(lower128(rl), lower128(rt));
+            dst[i + 1].store(higher128(rl), higher128(rt));
+        }
+
+        if (i < count)
+        {
+            vf32x4 rl, rt;
+            kernel(src[i].linear(), src[i].translation(), rl, rt);
+            dst[i].store(rl, rt);
+        }
+    }
+
+    void multiply(const Affine2D a[], const Affine2D& b, Affine2D dst[], size_t count) noexcept
+    {
+        const auto bl = b.linear();
+        const auto bt = b.translation();
+        return affine2d_batch(a, dst, count, [bl, bt](auto l, auto t, auto& rl, auto& rt)
+        {
+            using V = decltype(l);
+            detail::affine2d_multiply(l, t, detail::lanes<V>(bl), detail::lanes<V>(bt), rl, rt);
+        });
+    }
+
+    void inverse(const Affine2D src[], Affine2D dst[], size_t count) noexcept
+    {
+        return affine2d_batch(src, dst, count, [](auto l, auto t, auto& rl, auto& rt) { detail::affine2d_inverse(l, t, rl, rt); });
+    }
+
+    void to_matrix4x4(const Affine2D src[], Matrix4x4 dst[], size_t count) noexcept
+    {
+        for (size_t i = 0; i < count; i++)
+            dst[i] = to_matrix4x4(src[i]);
+    }
+
+    void transform_points(const Affine2D& m, const Vec2 src[], Vec2 dst[], size_t count) noexcept
+    {
+        using namespace arkxmm;
+
+        const vf32x4 l = m.linear();
+        const vf32x4 zero = arkxmm::zero<vf32x4>();
+        const vf32x8 m0 = f32x8(shuffle<0, 1, 0, 1>(l, zero));
+        const vf32x8 m1 = f32x8(shuffle<2, 3, 2, 3>(l, zero));
+        const vf32x8 m2 = f32x8(m.translation());
+
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8)
+        {
+            // all loads before stores, so src and dst may alias.
+            vf32x8 p01 = load_u<vf32x8>(src + i + 0);
+            vf32x8 p23 = load_u<vf32x8>(src + i + 2);
+            vf32x8 p45 = load_u<vf32x8>(src + i + 4);
+            vf32x8 p67 = load_u<vf32x8>(src + i + 6);
+            store_u<vf32x8>(dst + i + 0, transform_points_x2<2>(p01, m0, m1, m0, m2));
+            store_u<vf32x8>(dst + i + 2, transform_points_x2<2>(p23, m0, m1, m0, m2));
+            store_u<vf32x8>(dst + i + 4, transform_points_x2<2>(p45, m0, m1, m0, m2));
+            store_u<vf32x8>(dst + i + 6, transform_points_x2<2>(p67, m0, m1, m0, m2));
+        }
+
+        for (; i < count; i++)
+            dst[i] = transform(src[i], m);
+    }
+
+    // Runs Kernel(const In s[8], Out d[8]) over the arrays; the tail goes through a zero-padded copy
+    // so it gives exactly the same results as the vector body.
+    template <class In, class Out, class Kernel>
+    static void batch8(const In src[], Out dst[], size_t count, Kernel&& kernel) noexcept
+    {
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8)
+            kernel(src + i, dst + i);
+
+        if (size_t rest = count - i)
+        {
+            In s[8]{};
+            Out d[8]{};
+            std::copy_n(src + i, rest, s);
+            kernel(s, d);
+            std::copy_n(d, rest, dst + i);
+        }
+    }
+
+    // pshufb control moving bytes {p0, p1, p2, p3} of every 32-bit element to {0, 1, 2, 3}
+    static arkxmm::vi8x32 byte_order_control(int p0, int p1, int p2, int p3) noexcept
+    {
+        auto e = [=](int k) { return (4 * k + p0) | (4 * k + p1) << 8 | (4 * k + p2) << 16 | (4 * k + p3) << 24; };
+        return arkxmm::reinterpret<arkxmm::vi8x32>(arkxmm::i32x8(e(0), e(1), e(2), e(3), e(0), e(1), e(2), e(3)));
+    }
+
+    void pack_colors(const Color4 src[], uint32_t dst[], size_t count, ColorByteOrder order) noexcept
+    {
+        using namespace arkxmm;
+
+        const vi8x32 control =
+            order == ColorByteOrder::Bgra ? byte_order_control(2, 1, 0, 3) :
+            order == ColorByteOrder::Argb ? byte_order_control(3, 0, 1, 2) :
+            byte_order_control(0, 1, 2, 3);
+
+        batch8(src, dst, count, [control](const Color4* s, uint32_t* d)
+        {
+            auto quantize = [](const Color4* p)
+            {
+                vf32x8 v = load_u<vf32x8>(p);
+                return convert_cast<vi32x8>(min(max(v, 0.0f), 1.0f) * 255.0f + 0.5f);
+            };
+
+            // {c0,c2|c1,c3}, {c4,c6|c5,c7} as 16-bit, then {c0,c2,c4,c6|c1,c3,c5,c7} as 8-bit.
+            vi16x16 c0213 = pack_sat_i(quantize(s + 0), quantize(s + 2));
+            vi16x16 c4657 = pack_sat_i(quantize(s + 4), quantize(s + 6));
+            vu8x32 c = pack_sat_u(c0213, c4657);
+            c = permute32<0, 4, 1, 5, 2, 6, 3, 7>(byte_shuffle_128(c, control));
+            store_u<vu8x32>(d, c);
+        });
+    }
+
+    void unpack_colors(const uint32_t src[], Color4 dst[], size_t count, ColorByteOrder order) noexcept
+    {
+        using namespace arkxmm;
+
+        const vi8x32 control =
+            order == ColorByteOrder::Bgra ? byte_order_control(2, 1, 0, 3) :
+            order == ColorByteOrder::Argb ? byte_order_control(1, 2, 3, 0) :
+            byte_order_control(0, 1, 2, 3);
+
+        batch8(src, dst, count, [control](const uint32_t* s, Color4* d)
+        {
+            vu8x32 c = byte_shuffle_128(load_u<vu8x32>(s), control); // {c0..c3|c4..c7} as R,G,B,A bytes
+            auto expand = [](vu8x16 c01) { return convert_cast<vf32x8>(convert_cast<vi32x8>(c01)) / 255.0f; };
+            store_u<vf32x8>(d + 0, expand(lower128(c)));
+            store_u<vf32x8>(d + 2, expand(byte_shift_r_128<8>(lower128(c))));
+            store_u<vf32x8>(d + 4, expand(higher128(c)));
+            store_u<vf32x8>(d + 6, expand(byte_shift_r_128<8>(higher128(c))));
+        });
+    }
+
+    // log2(x) for normal x > 0, |relative error| < 2e-7 (Cephes logf)
+    ARKXMM_API log2_positive(arkxmm::vf32x8 x) noexcept -> arkxmm::vf32x8
+    {
+        using namespace arkxmm;
+
+        // x = m * 2^e, m in [sqrt(1/2), sqrt(2))
+        __m256i bits = _mm256_castps_si256(x.v);
+        vf32x8 m = {_mm256_castsi256_ps(_mm256_or_si256(_mm256_and_si256(bits, _mm256_set1_epi32(0x007FFFFF)), _mm256_set1_epi32(0x3F000000)))};
+        vf32x8 e = convert_cast<vf32x8>(vi32x8{_mm256_sub_epi32(_mm256_srli_epi32(bits, 23), _mm256_set1_epi32(126))});
+        vf32x8 small = m < f32x8(0.707106781f);
+        e = e - (f32x8(1.0f) & small);
+        m = m + (m & small) - f32x8(1.0f);
+
+        vf32x8 z = m * m;
+        vf32x8 p = f32x8(7.0376836292E-2f);
+        p = p * m + f32x8(-1.1514610310E-1f);
+        p = p * m + f32x8(1.1676998740E-1f);
+        p = p * m + f32x8(-1.2420140846E-1f);
+        p = p * m + f32x8(1.4249322787E-1f);
+        p = p * m + f32x8(-1.6668057665E-1f);
+        p = p * m + f32x8(2.0000714765E-1f);
+        p = p * m + f32x8(-2.4999993993E-1f);
+        p = p * m + f32x8(3.3333331174E-1f);
+        vf32x8 ln = m + p * m * z - z * 0.5f;
+        return ln * 1.44269504089f + e;
+    }
+
+    // 2^x, |relative error| < 2e-7 (Cephes exp2f); x is clamped to [-126, 126]
+    ARKXMM_API exp2_clamped(arkxmm::vf32x8 x) noexcept -> arkxmm::vf32x8
+    {
+        using namespace arkxmm;
+
+        x = min(max(x, -126.0f), 126.0f);
+        __m256i n = _mm256_cvtps_epi32(x.v); // round to nearest
+        vf32x8 f = x - convert_cast<vf32x8>(vi32x8{n});
+
+        vf32x8 p = f32x8(1.535336188319500E-4f);
+        p = p * f + f32x8(1.339887440266574E-3f);
+        p = p * f + f32x8(9.618437357674640E-3f);
+        p = p * f + f32x8(5.550332471162809E-2f);
+        p = p * f + f32x8(2.402264791363012E-1f);
+        p = p * f + f32x8(6.931472028550421E-1f);
+        p = p * f + f32x8(1.0f);
+        return {_mm256_castsi256_ps(_mm256_add_epi32(_mm256_castps_si256(p.v), _mm256_slli_epi32(n, 23)))};
+    }
+
+    // Applies F to r, g, b of 8 colors, 2 per register; alpha is kept.
+    template <class F>
+    static void color_rgb_batch(const Color4 src[], Color4 dst[], size_t count, F&& f) noexcept
+    {
+        using namespace arkxmm;
+        batch8(src, dst, count, [&f](const Color4* s, Color4* d)
+        {
+            vf32x8 c01 = load_u<vf32x8>(s + 0);
+            vf32x8 c23 = load_u<vf32x8>(s + 2);
+            vf32x8 c45 = load_u<vf32x8>(s + 4);
+            vf32x8 c67 = load_u<vf32x8>(s + 6);
+            store_u<vf32x8>(d + 0, blend<0b10001000>(f(c01), c01));
+            store_u<vf32x8>(d + 2, blend<0b10001000>(f(c23), c23));
+            store_u<vf32x8>(d + 4, blend<0b10001000>(f(c45), c45));
+            store_u<vf32x8>(d + 6, blend<0b10001000>(f(c67), c67));
+        });
+    }
+
+    void linear_to_srgb(const Color4 src[], Color4 dst[], size_t count) noexcept
+    {
+        using namespace arkxmm;
+        color_rgb_batch(src, dst, count, [](vf32x8 x)
+        {
+            vf32x8 curve = exp2_clamped(log2_positive(x) * (1.0f / 2.4f)) * 1.055f - 0.055f;
+            return blend(curve, x * 12.92f, x <= f32x8(0.0031308f));
+        });
+    }
+
+    void srgb_to_linear(const Color4 src[], Color4 dst[], size_t count) noexcept
+    {
+        using namespace arkxmm;
+        color_rgb_batch(src, dst, count, [](vf32x8 x)
+        {
+            vf32x8 curve = exp2_clamped(log2_positive((x + 0.055f) * (1.0f / 1.055f)) * 2.4f);
+            return blend(curve, x * (1.0f / 12.92f), x <= f32x8(0.04045f));
+        });
+    }
+
+    void premultiply_alpha(const Color4 src[], Color4 dst[], size_t count) noexcept
+    {
+        using namespace arkxmm;
+        color_rgb_batch(src, dst, count, [](vf32x8 c) { return c * shuffle<3, 3, 3, 3>(c); });
+    }
+
+    void unpremultiply_alpha(const Color4 src[], Color4 dst[], size_t count) noexcept
+    {
+        using namespace arkxmm;
+        batch8(src, dst, count, [](const Color4* s, Color4* d)
+        {
+            for (size_t k = 0; k < 8; k += 2)
+            {
+                vf32x8 c = load_u<vf32x8>(s + k);
+                vf32x8 a = shuffle<3, 3, 3, 3>(c);
+                vf32x8 r = blend<0b10001000>(c / a, c);
+                store_u<vf32x8>(d + k, masked_not(a == zero<vf32x8>(), r)); // a == 0: transparent black
+            }
+        });
+    }
+
+    void float_to_half(const float src[], arkxmm::float16_t dst[], size_t count) noexcept
+    {
+        using namespace arkxmm;
+        batch8(src, dst, count, [](const float* s, float16_t* d)
+        {
+            store_u<vf16x8>(d, convert_cast<vf16x8>(load_u<vf32x8>(s)));
+        });
+    }
+
+    void half_to_float(const arkxmm::float16_t src[], float dst[], size_t count) noexcept
+    {
+        using namespace arkxmm;
+        batch8(src, dst, count, [](const float16_t* s, float* d)
+        {
+            store_u<vf32x8>(d, convert_cast<vf32x8>(load_u<vf16x8>(s)));
+        });
+    }
+}
@@ -4,10 +4,6 @@
 
 #pragma once
 
-#if !defined(DIRECTX_MATH_VERSION) //< if DirectXMath is not included
-#include <DirectXMath.h>
-#endif
-
 #include <cmath>
 #include <algorithm>
 
@@ -21,12 +17,23 @@
 
 namespace sandy
 {
+    namespace detail
+    {
+        // {x, y, z, w} usable in constant expressions: brace-initializes the register type
+        // (m128_f32 on MSVC) while constant-evaluating, and uses the set intrinsic at run time.
+        constexpr arkxmm::vf32x4 constant_f32x4(float x, float y, float z, float w) noexcept
+        {
+            if (__builtin_is_constant_evaluated()) return arkxmm::vf32x4{__m128{x, y, z, w}};
+            return arkxmm::f32x4(x, y, z, w);
+        }
+    }
+
     struct Vec2
     {
         arkxmm::vf32x4 v;
         using vector_bit_mask = std::integral_constant<uint8_t, 0b0011>;
-        Vec2(arkxmm::vf32x4 v = arkxmm::zero<arkana::xmm::vf32x4>()) noexcept : v{v} {}
-        Vec2(float x, float y, float z = 0.0f, float w = 0.0f) noexcept : v{arkxmm::f32x4(x, y, z, w)} {}
+        constexpr Vec2(arkxmm::vf32x4 v = detail::constant_f32x4(0.0f, 0.0f, 0.0f, 0.0f)) noexcept : v{v} {}
+        constexpr Vec2(float x, float y, float z = 0.0f, float w = 0.0f) noexcept : v{detail::constant_f32x4(x, y, z, w)} {}
         [[nodiscard]] float x() const noexcept { return arkxmm::extract_element<0>(v); }
         [[nodiscard]] float y() const noexcept { return arkxmm::extract_element<1>(v); }
     };
@@ -35,8 +42,8 @@ namespace sandy
     {
         arkxmm::vf32x4 v;
         using vector_bit_mask = std::integral_constant<uint8_t, 0b0111>;
-        Vec3(arkxmm::vf32x4 v = arkxmm::zero<arkana::xmm::vf32x4>()) noexcept : v{v} {}
-        Vec3(float x, float y, float z, float w = 0.0f) : v{arkxmm::f32x4(x, y, z, w)} {}
+        constexpr Vec3(arkxmm::vf32x4 v = detail::constant_f32x4(0.0f, 0.0f, 0.0f, 0.0f)) noexcept : v{v} {}
+        constexpr Vec3(float x, float y, float z, float w = 0.0f) : v{detail::constant_f32x4(x, y, z, w)} {}
         [[nodiscard]] float x() const noexcept { return arkxmm::extract_element<0>(v); }
         [[nodiscard]] float y() const noexcept { return arkxmm::extract_element<1>(v); }
         [[nodiscard]] float z() const noexcept { return arkxmm::extract_element<2>(v); }
@@ -46,8 +53,8 @@ namespace sandy
     {
         arkxmm::vf32x4 v;
         using vector_bit_mask = std::integral_constant<uint8_t, 0b1111>;
-        Vec4(arkxmm::vf32x4 v = arkxmm::zero<arkana::xmm::vf32x4>()) noexcept : v{v} {}
-        Vec4(float x, float y, float z, float w) : v{arkxmm::f32x4(x, y, z, w)} {}
+        constexpr Vec4(arkxmm::vf32x4 v = detail::constant_f32x4(0.0f, 0.0f, 0.0f, 0.0f)) noexcept : v{v} {}
+        constexpr Vec4(float x, float y, float z, float w) : v{detail::constant_f32x4(x, y, z, w)} {}
         [[nodiscard]] float x() const noexcept { return arkxmm::extract_element<0>(v); }
         [[nodiscard]] float y() const noexcept { return arkxmm::extract_element<1>(v); }
         [[nodiscard]] float z() const noexcept { return arkxmm::extract_element<2>(v); }
@@ -57,8 +64,8 @@ namespace sandy
     struct PositionVector
     {
         arkxmm::vf32x4 v;
-        PositionVector(float x = 0.0f, float y = 0.0f, float z = 0.0f, float w = 1.0f) noexcept : v{arkxmm::f32x4(x, y, z, w)} { }
-        PositionVector(arkxmm::vf32x4 v) noexcept : v{v} { }
+        constexpr PositionVector(float x = 0.0f, float y = 0.0f, float z = 0.0f, float w = 1.0f) noexcept : v{detail::constant_f32x4(x, y, z, w)} { }
+        constexpr PositionVector(arkxmm::vf32x4 v) noexcept : v{v} { }
         PositionVector(Vec2 xy, float z = 0.0f, float w = 1.0f) noexcept : v{arkxmm::vf32x4{_mm_movelh_ps(xy.v.v, arkxmm::f32x4(z, w, 0.0f, 0.0f).v)}} { }
         PositionVector(Vec3 xyz, float w = 1.0f) noexcept : v{arkxmm::insert_element<3>(xyz.v, w)} { }
     };
@@ -66,8 +73,8 @@ namespace sandy
     struct NormalVector
     {
         arkxmm::vf32x4 v;
-        NormalVector(float x = 0.0f, float y = 0.0f, float z = 0.0f, float w = 0.0f) noexcept : v{arkxmm::f32x4(x, y, z, w)} { }
-        NormalVector(arkxmm::vf32x4 v) noexcept : v{v} { }
+        constexpr NormalVector(float x = 0.0f, float y = 0.0f, float z = 0.0f, float w = 0.0f) noexcept : v{detail::constant_f32x4(x, y, z, w)} { }
+        constexpr NormalVector(arkxmm::vf32x4 v) noexcept : v{v} { }
         NormalVector(Vec2 xy, float z = 0.0f, float w = 0.0f) noexcept : v{arkxmm::vf32x4{_mm_movelh_ps(xy.v.v, arkxmm::f32x4(z, w, z, w).v)}} { }
         NormalVector(Vec3 xyz, float w = 0.0f) noexcept : v{arkxmm::insert_element<3>(xyz.v, w)} { }
     };
@@ -119,14 +126,14 @@ namespace sandy
 
     struct Matrix4x4
     {
-        arkxmm::vf32x4 m0 = arkxmm::zero<arkxmm::vf32x4>();
-        arkxmm::vf32x4 m1 = arkxmm::zero<arkxmm::vf32x4>();
-        arkxmm::vf32x4 m2 = arkxmm::zero<arkxmm::vf32x4>();
-        arkxmm::vf32x4 m3 = arkxmm::zero<arkxmm::vf32x4>();
+        arkxmm::vf32x4 m0 = detail::constant_f32x4(0.0f, 0.0f, 0.0f, 0.0f);
+        arkxmm::vf32x4 m1 = detail::constant_f32x4(0.0f, 0.0f, 0.0f, 0.0f);
+        arkxmm::vf32x4 m2 = detail::constant_f32x4(0.0f, 0.0f, 0.0f, 0.0f);
+        arkxmm::vf32x4 m3 = detail::constant_f32x4(0.0f, 0.0f, 0.0f, 0.0f);
 
-        Matrix4x4() noexcept = default;
+        constexpr Matrix4x4() noexcept = default;
 
-        Matrix4x4(Vec4 m0, Vec4 m1, Vec4 m2, Vec4 m3) noexcept
+        constexpr Matrix4x4(Vec4 m0, Vec4 m1, Vec4 m2, Vec4 m3) noexcept
             : m0(m0.v), m1(m1.v), m2(m2.v), m3(m3.v) { }
 
         Matrix4x4(const float p[16]) noexcept
@@ -135,22 +142,36 @@ namespace sandy
             , m2(arkxmm::load_u<arkxmm::vf32x4>(p + 8))
             , m3(arkxmm::load_u<arkxmm::vf32x4>(p + 12)) { }
 
-        Matrix4x4(
+        constexpr Matrix4x4(
             float m00, float m01, float m02, float m03,
             float m10, float m11, float m12, float m13,
             float m20, float m21, float m22, float m23,
             float m30, float m31, float m32, float m33) noexcept
-            : m0(arkxmm::f32x4(m00, m01, m02, m03))
-            , m1(arkxmm::f32x4(m10, m11, m12, m13))
-            , m2(arkxmm::f32x4(m20, m21, m22, m23))
-            , m3(arkxmm::f32x4(m30, m31, m32, m33)) { }
+            : m0(detail::constant_f32x4(m00, m01, m02, m03))
+            , m1(detail::constant_f32x4(m10, m11, m12, m13))
+            , m2(detail::constant_f32x4(m20, m21, m22, m23))
+            , m3(detail::constant_f32x4(m30, m31, m32, m33)) { }
 
+#if defined(DIRECTX_MATH_VERSION) //< if DirectXMath is included
         explicit Matrix4x4(DirectX::XMMATRIX m) noexcept
             : m0({m.r[0]}), m1({m.r[1]}), m2({m.r[2]}), m3({m.r[3]}) { }
+#endif
     };
 
     ARKXMM_API transpose(Matrix4x4 a) noexcept -> Matrix4x4;
-    ARKXMM_API inverse(Matrix4x4 a) noexcept -> Matrix4x4;
+    ARKXMM_API inverse(Matrix4x4 a) noexcept -> Matrix4x4;             // general 4x4
+    ARKXMM_API inverse_affine(Matrix4x4 a) noexcept -> Matrix4x4;      // 3x3 + translation: m0.w = m1.w = m2.w = 0, m3.w = 1
+    ARKXMM_API inverse_orthonormal(Matrix4x4 a) noexcept -> Matrix4x4; // rotation + translation
+
+    // Batch inverses: dst[i] = inverse(src[i]), 2 matrices per iteration. src and dst may be the same array.
+    void inverse(const Matrix4x4 src[], Matrix4x4 dst[], size_t count) noexcept;
+    void inverse_affine(const Matrix4x4 src[], Matrix4x4 dst[], size_t count) noexcept;
+    void inverse_orthonormal(const Matrix4x4 src[], Matrix4x4 dst[], size_t count) noexcept;
+
+    // Batch multiply and transpose, 2 matrices per iteration. a/src and dst may be the same array.
+    void multiply(const Matrix4x4 a[], const Matrix4x4& b, Matrix4x4 dst[], size_t count) noexcept;           // dst[i] = a[i] * b
+    void multiply_transpose(const Matrix4x4 a[], const Matrix4x4& b, Matrix4x4 dst[], size_t count) noexcept; // dst[i] = transpose(a[i] * b)
+    void transpose(const Matrix4x4 src[], Matrix4x4 dst[], size_t count) noexcept;
 
     ARKXMM_API operator +(Matrix4x4 a, Matrix4x4 b) noexcept -> Matrix4x4 { return Matrix4x4{a.m0 + b.m0, a.m1 + b.m1, a.m2 + b.m2, a.m3 + b.m3}; }
     ARKXMM_API operator -(Matrix4x4 a, Matrix4x4 b) noexcept -> Matrix4x4 { return Matrix4x4{a.m0 - b.m0, a.m1 - b.m1, a.m2 - b.m2, a.m3 - b.m3}; }
@@ -161,9 +182,9 @@ namespace sandy
 
     namespace matrix4x4
     {
-        ARKXMM_API Zero() noexcept -> Matrix4x4 { return {}; };
+        static constexpr auto Zero() noexcept -> Matrix4x4 { return {}; };
 
-        ARKXMM_API Identity() noexcept -> Matrix4x4
+        static constexpr auto Identity() noexcept -> Matrix4x4
         {
             return {
                 {1.0f, 0.0f, 0.0f, 0.0f},
@@ -198,19 +219,152 @@ namespace sandy
         return m;
     }
 
+    namespace detail
+    {
+        // Broadcasts 128-bit v to each 128-bit lane of V.
+        template <class V>
+        ARKXMM_API lanes(arkxmm::vf32x4 v) noexcept -> V
+        {
+            if constexpr (std::is_same_v<V, arkxmm::vf32x4>) return v;
+            else return arkxmm::f32x8(v);
+        }
+
+        // The matrix kernels below work on each 128-bit lane of V independently:
+        // V = vf32x4 processes one matrix, V = vf32x8 processes two matrices {a|b}.
+
+        // Row vector times matrix: r * | b0 b1 b2 b3 |^T
+        template <class V>
+        ARKXMM_API multiply_row(V r, V b0, V b1, V b2, V b3) noexcept -> V
+        {
+            using arkxmm::shuffle;
+            return shuffle<0, 0, 0, 0>(r) * b0 + shuffle<1, 1, 1, 1>(r) * b1 + shuffle<2, 2, 2, 2>(r) * b2 + shuffle<3, 3, 3, 3>(r) * b3;
+        }
+
+        // General inverse by 2x2 block matrices.
+        template <class V>
+        ARKXMM_API inverse_4x4(V& m0, V& m1, V& m2, V& m3) noexcept -> void
+        {
+            using arkxmm::shuffle;
+
+            // 2x2 matrix {a, b, c, d} operations
+            auto mul = [](V a, V b) { return a * shuffle<0, 3, 0, 3>(b) + shuffle<1, 0, 3, 2>(a) * shuffle<2, 1, 2, 1>(b); };     // A * B
+            auto adj_mul = [](V a, V b) { return shuffle<3, 3, 0, 0>(a) * b - shuffle<1, 1, 2, 2>(a) * shuffle<2, 3, 0, 1>(b); }; // adj(A) * B
+            auto mul_adj = [](V a, V b) { return a * shuffle<3, 0, 3, 0>(b) - shuffle<1, 0, 3, 2>(a) * shuffle<2, 1, 2, 1>(b); }; // A * adj(B)
+
+            // M = | A B |
+            //     | C D |
+            V a = shuffle<0, 1, 0, 1>(m0, m1);
+            V b = shuffle<2, 3, 2, 3>(m0, m1);
+            V c = shuffle<0, 1, 0, 1>(m2, m3);
+            V d = shuffle<2, 3, 2, 3>(m2, m3);
+
+            // {|A|, |B|, |C|, |D|}
+            V det_sub = shuffle<0, 2, 0, 2>(m0, m2) * shuffle<1, 3, 1, 3>(m1, m3) - shuffle<1, 3, 1, 3>(m0, m2) * shuffle<0, 2, 0, 2>(m1, m3);
+            V det_a = shuffle<0, 0, 0, 0>(det_sub);
+            V det_b = shuffle<1, 1, 1, 1>(det_sub);
+            V det_c = shuffle<2, 2, 2, 2>(det_sub);
+            V det_d = shuffle<3, 3, 3, 3>(det_sub);
+
+            // inverse(M) = 1/|M| * | adj(X) adj(Y) |
+            //                      | adj(Z) adj(W) |
+            V d_c = adj_mul(d, c);
+            V a_b = adj_mul(a, b);
+            V x = det_d * a - mul(b, d_c);
+            V y = det_b * c - mul_adj(d, a_b);
+            V z = det_c * b - mul_adj(a, d_c);
+            V w = det_a * d - mul(c, a_b);
+
+            // |M| = |A||D| + |B||C| - tr(adj(A) B adj(D) C)
+            V tr = a_b * shuffle<0, 2, 1, 3>(d_c);
+            tr = tr + shuffle<2, 3, 0, 1>(tr);
+            tr = tr + shuffle<1, 0, 3, 2>(tr);
+            V det = det_a * det_d + det_b * det_c - tr;
+
+            V rcp_det = lanes<V>(arkxmm::f32x4(1.0f, -1.0f, -1.0f, 1.0f)) / det; // with adjugate signs
+            x = x * rcp_det;
+            y = y * rcp_det;
+            z = z * rcp_det;
+            w = w * rcp_det;
+
+            // adjugate and re-assemble
+            m0 = shuffle<3, 1, 3, 1>(x, y);
+            m1 = shuffle<2, 0, 2, 0>(x, y);
+            m2 = shuffle<3, 1, 3, 1>(z, w);
+            m3 = shuffle<2, 0, 2, 0>(z, w);
+        }
+
+        // Inverse translation: t' = -t * inverse(L), where r0..r2 = inverse(L)
+        template <class V>
+        ARKXMM_API inverse_translation(V t, V r0, V r1, V r2) noexcept -> V
+        {
+            using arkxmm::shuffle;
+            return lanes<V>(arkxmm::f32x4(0.0f, 0.0f, 0.0f, 1.0f)) - (shuffle<0, 0, 0, 0>(t) * r0 + shuffle<1, 1, 1, 1>(t) * r1 + shuffle<2, 2, 2, 2>(t) * r2);
+        }
+
+        // Affine inverse: 3x3 linear part by cross products, then translation.
+        template <class V>
+        ARKXMM_API inverse_affine_4x4(V& m0, V& m1, V& m2, V& m3) noexcept -> void
+        {
+            using arkxmm::shuffle;
+            auto cross = [](V a, V b) { return shuffle<1, 2, 0, 3>(a) * shuffle<2, 0, 1, 3>(b) - shuffle<2, 0, 1, 3>(a) * shuffle<1, 2, 0, 3>(b); };
+
+            // columns of adj(L)
+            V c0 = cross(m1, m2);
+            V c1 = cross(m2, m0);
+            V c2 = cross(m0, m1);
+
+            // |L| = m0 . (m1 x m2)
+            V det = m0 * c0;
+            det = shuffle<0, 0, 0, 0>(det) + shuffle<1, 1, 1, 1>(det) + shuffle<2, 2, 2, 2>(det);
+
+            V rcp_det = lanes<V>(arkxmm::f32x4(1.0f)) / det;
+            c0 = c0 * rcp_det;
+            c1 = c1 * rcp_det;
+            c2 = c2 * rcp_det;
+
+            V c3 = arkxmm::zero<V>();
+            arkxmm::transpose_32x4x4(c0, c1, c2, c3);
+            m3 = inverse_translation(m3, c0, c1, c2);
+            m0 = c0;
+            m1 = c1;
+            m2 = c2;
+        }
+
+        // Orthonormal inverse: transposed 3x3 rotation, then translation.
+        template <class V>
+        ARKXMM_API inverse_orthonormal_4x4(V& m0, V& m1, V& m2, V& m3) noexcept -> void
+        {
+            V r3 = arkxmm::zero<V>();
+            arkxmm::transpose_32x4x4(m0, m1, m2, r3);
+            m3 = inverse_translation(m3, m0, m1, m2);
+        }
+    }
+
     ARKXMM_API inverse(Matrix4x4 a) noexcept -> Matrix4x4
     {
-        return Matrix4x4(DirectX::XMMatrixInverse(nullptr, DirectX::XMMATRIX{a.m0.v, a.m1.v, a.m2.v, a.m3.v}));
+        detail::inverse_4x4(a.m0, a.m1, a.m2, a.m3);
+        return a;
+    }
+
+    ARKXMM_API inverse_affine(Matrix4x4 a) noexcept -> Matrix4x4
+    {
+        detail::inverse_affine_4x4(a.m0, a.m1, a.m2, a.m3);
+        return a;
+    }
+
+    ARKXMM_API inverse_orthonormal(Matrix4x4 a) noexcept -> Matrix4x4
+    {
+        detail::inverse_orthonormal_4x4(a.m0, a.m1, a.m2, a.m3);
+        return a;
     }
 
     ARKXMM_API operator *(Matrix4x4 a, Matrix4x4 b) noexcept -> Matrix4x4
     {
-        auto t = transpose(b);
         return {
-            dot<0b1111, 0b0001>(a.m0, t.m0) | dot<0b1111, 0b0010>(a.m0, t.m1) | dot<0b1111, 0b0100>(a.m0, t.m2) | dot<0b1111, 0b1000>(a.m0, t.m3),
-            dot<0b1111, 0b0001>(a.m1, t.m0) | dot<0b1111, 0b0010>(a.m1, t.m1) | dot<0b1111, 0b0100>(a.m1, t.m2) | dot<0b1111, 0b1000>(a.m1, t.m3),
-            dot<0b1111, 0b0001>(a.m2, t.m0) | dot<0b1111, 0b0010>(a.m2, t.m1) | dot<0b1111, 0b0100>(a.m2, t.m2) | dot<0b1111, 0b1000>(a.m2, t.m3),
-            dot<0b1111, 0b0001>(a.m3, t.m0) | dot<0b1111, 0b0010>(a.m3, t.m1) | dot<0b1111, 0b0100>(a.m3, t.m2) | dot<0b1111, 0b1000>(a.m3, t.m3),
+            detail::multiply_row(a.m0, b.m0, b.m1, b.m2, b.m3),
+            detail::multiply_row(a.m1, b.m0, b.m1, b.m2, b.m3),
+            detail::multiply_row(a.m2, b.m0, b.m1, b.m2, b.m3),
+            detail::multiply_row(a.m3, b.m0, b.m1, b.m2, b.m3),
         };
     }
 
@@ -315,17 +469,33 @@ namespace sandy
 
         ARKXMM_API LookTo(Vec3 camera_position, Vec3 look_to, Vec3 up) noexcept -> Matrix4x4
         {
-            return Matrix4x4(DirectX::XMMatrixLookToLH(camera_position.v.v, look_to.v.v, up.v.v));
+            // left-handed, same as XMMatrixLookToLH
+            auto z_axis = Vec3{look_to.v / arkxmm::sqrt(arkxmm::dot<0b0111, 0b1111>(look_to.v, look_to.v))};
+            auto x_axis = cross(up, z_axis);
+            x_axis = Vec3{x_axis.v / arkxmm::sqrt(arkxmm::dot<0b0111, 0b1111>(x_axis.v, x_axis.v))};
+            auto y_axis = cross(z_axis, x_axis);
+
+            // view = inverse(camera world)
+            return inverse_orthonormal(Matrix4x4(
+                arkxmm::insert_element<3>(x_axis.v, 0.0f),
+                arkxmm::insert_element<3>(y_axis.v, 0.0f),
+                arkxmm::insert_element<3>(z_axis.v, 0.0f),
+                PositionVector(camera_position).v));
         }
 
         ARKXMM_API LookAt(Vec3 camera_position, Vec3 look_at, Vec3 up) noexcept -> Matrix4x4
         {
-            return Matrix4x4(DirectX::XMMatrixLookAtLH(camera_position.v.v, look_at.v.v, up.v.v));
+            return LookTo(camera_position, look_at - camera_position, up);
         }
 
         ARKXMM_API Orthographic(float screen_width, float screen_height, float near_clip, float far_clip) noexcept -> Matrix4x4
         {
-            return Matrix4x4(DirectX::XMMatrixOrthographicLH(screen_width, screen_height, near_clip, far_clip));
+            float range = 1.0f / (far_clip - near_clip);
+            return Matrix4x4(
+                2.0f / screen_width, 0.0f, 0.0f, 0.0f,
+                0.0f, 2.0f / screen_height, 0.0f, 0.0f,
+                0.0f, 0.0f, range, 0.0f,
+                0.0f, 0.0f, -range * near_clip, 1.0f);
         }
 
         ARKXMM_API Orthographic2D(float screen_width, float screen_height) noexcept -> Matrix4x4
@@ -339,7 +509,296 @@ namespace sandy
 
         ARKXMM_API PerspectiveFov(float fov_degree, float screen_width, float screen_height, float near_clip, float far_clip) noexcept -> Matrix4x4
         {
-            return Matrix4x4(DirectX::XMMatrixPerspectiveFovLH(DirectX::XMConvertToRadians(fov_degree), screen_width / screen_height, near_clip, far_clip));
+            float half_fov = fov_degree * (3.14159265358979f / 360.0f);
+            float height = std::cosf(half_fov) / std::sinf(half_fov);
+            float width = height * screen_height / screen_width;
+            float range = far_clip / (far_clip - near_clip);
+            return Matrix4x4(
+                width, 0.0f, 0.0f, 0.0f,
+                0.0f, height, 0.0f, 0.0f,
+                0.0f, 0.0f, range, 1.0f,
+                0.0f, 0.0f, -range * near_clip, 0.0f);
+        }
+    }
+
+#pragma endregion
+
+#pragma region point transforms
+
+    /// Transforms point: p' = p * m
+    ARKXMM_API transform(PositionVector p, Matrix4x4 m) noexcept -> PositionVector
+    {
+        return PositionVector{
+            arkxmm::shuffle<0, 0, 0, 0>(p.v) * m.m0 +
+            arkxmm::shuffle<1, 1, 1, 1>(p.v) * m.m1 +
+            arkxmm::shuffle<2, 2, 2, 2>(p.v) * m.m2 +
+            arkxmm::shuffle<3, 3, 3, 3>(p.v) * m.m3
+        };
+    }
+
+    /// Transforms point (x, y, 0, 1).
+    ARKXMM_API transform(Vec2 p, Matrix4x4 m) noexcept -> PositionVector
+    {
+        return PositionVector{
+            arkxmm::shuffle<0, 0, 0, 0>(p.v) * m.m0 +
+            arkxmm::shuffle<1, 1, 1, 1>(p.v) * m.m1 +
+            m.m3
+        };
+    }
+
+    /// Transforms point (x, y, z, 1).
+    ARKXMM_API transform(Vec3 p, Matrix4x4 m) noexcept -> PositionVector
+    {
+        return PositionVector{
+            arkxmm::shuffle<0, 0, 0, 0>(p.v) * m.m0 +
+            arkxmm::shuffle<1, 1, 1, 1>(p.v) * m.m1 +
+            arkxmm::shuffle<2, 2, 2, 2>(p.v) * m.m2 +
+            m.m3
+        };
+    }
+
+    // Batch transforms: dst[i] = transform(src[i], m), 8 points per iteration.
+    // src and dst may be the same array. Strides are in bytes.
+    void transform_points(const Matrix4x4& m, const Vec2 src[], PositionVector dst[], size_t count) noexcept;
+    void transform_points(const Matrix4x4& m, const Vec3 src[], PositionVector dst[], size_t count) noexcept;
+    void transform_points(const Matrix4x4& m, const PositionVector src[], PositionVector dst[], size_t count) noexcept;
+    void transform_points(const Matrix4x4& m, const PositionVector* src, size_t src_stride, PositionVector* dst, size_t dst_stride, size_t count) noexcept;
+
+#pragma endregion
+
+#pragma region Quaternion
+
+    struct Quaternion
+    {
+        arkxmm::vf32x4 v; // {x, y, z, w}
+        constexpr Quaternion(arkxmm::vf32x4 v = detail::constant_f32x4(0.0f, 0.0f, 0.0f, 1.0f)) noexcept : v{v} { }
+        constexpr Quaternion(float x, float y, float z, float w) noexcept : v{detail::constant_f32x4(x, y, z, w)} { }
+        [[nodiscard]] float x() const noexcept { return arkxmm::extract_element<0>(v); }
+        [[nodiscard]] float y() const noexcept { return arkxmm::extract_element<1>(v); }
+        [[nodiscard]] float z() const noexcept { return arkxmm::extract_element<2>(v); }
+        [[nodiscard]] float w() const noexcept { return arkxmm::extract_element<3>(v); }
+    };
+
+    /// Composes rotations: a then b (same order as Matrix4x4 product).
+    ARKXMM_API operator *(Quaternion a, Quaternion b) noexcept -> Quaternion
+    {
+        // Hamilton product b * a
+        using arkxmm::shuffle;
+        auto p = b.v;
+        auto q = a.v;
+        return Quaternion{
+            shuffle<3, 3, 3, 3>(p) * q +
+            shuffle<0, 0, 0, 0>(p) * shuffle<3, 2, 1, 0>(q) * arkxmm::f32x4(+1.0f, -1.0f, +1.0f, -1.0f) +
+            shuffle<1, 1, 1, 1>(p) * shuffle<2, 3, 0, 1>(q) * arkxmm::f32x4(+1.0f, +1.0f, -1.0f, -1.0f) +
+            shuffle<2, 2, 2, 2>(p) * shuffle<1, 0, 3, 2>(q) * arkxmm::f32x4(-1.0f, +1.0f, +1.0f, -1.0f)
+        };
+    }
+
+    ARKXMM_API operator *=(Quaternion& a, Quaternion b) noexcept -> Quaternion& { return a = a * b; }
+
+    ARKXMM_API dot(Quaternion a, Quaternion b) noexcept -> float { return arkxmm::extract_element<0>(arkxmm::dot<0b1111, 0b0001>(a.v, b.v)); }
+    ARKXMM_API conjugate(Quaternion q) noexcept -> Quaternion { return Quaternion{q.v * arkxmm::f32x4(-1.0f, -1.0f, -1.0f, 1.0f)}; }
+    ARKXMM_API normalize(Quaternion q) noexcept -> Quaternion { return Quaternion{q.v / arkxmm::sqrt(arkxmm::dot<0b1111, 0b1111>(q.v, q.v))}; }
+
+    /// Rotates vector by unit quaternion.
+    ARKXMM_API rotate(Vec3 v, Quaternion q) noexcept -> Vec3
+    {
+        // v' = v + w * t + u x t, where t = 2 * (u x v)
+        auto u = Vec3{q.v};
+        auto t = cross(u, v) * 2.0f;
+        return v + t * q.w() + cross(u, t);
+    }
+
+    /// Normalized linear interpolation (shortest path)
+    ARKXMM_API nlerp(Quaternion a, Quaternion b, float t) noexcept -> Quaternion
+    {
+        if (dot(a, b) < 0.0f) b.v = b.v * -1.0f;
+        return normalize(Quaternion{a.v + (b.v - a.v) * t});
+    }
+
+    /// Spherical linear interpolation (shortest path)
+    ARKXMM_API slerp(Quaternion a, Quaternion b, float t) noexcept -> Quaternion
+    {
+        float d = dot(a, b);
+        if (d < 0.0f) b.v = b.v * -1.0f, d = -d;
+        if (d > 0.9995f) return nlerp(a, b, t); // nearly parallel
+
+        float theta = std::acos(d);
+        float wa = std::sin((1.0f - t) * theta);
+        float wb = std::sin(t * theta);
+        return normalize(Quaternion{a.v * wa + b.v * wb});
+    }
+
+    // Batch interpolations: dst[i] = nlerp/slerp(a[i], b[i], t[i]), 8 per iteration.
+    void nlerp(const Quaternion a[], const Quaternion b[], const float t[], Quaternion dst[], size_t count) noexcept;
+    void slerp(const Quaternion a[], const Quaternion b[], const float t[], Quaternion dst[], size_t count) noexcept;
+
+    namespace quaternion
+    {
+        static constexpr auto Identity() noexcept -> Quaternion { return {}; }
+
+        ARKXMM_API RotationAxis(Vec3 axis, float angle) noexcept -> Quaternion
+        {
+            auto n = axis.v / arkxmm::sqrt(arkxmm::dot<0b0111, 0b1111>(axis.v, axis.v));
+            return Quaternion{arkxmm::insert_element<3>(n * std::sinf(angle * 0.5f), std::cosf(angle * 0.5f))};
+        }
+
+        /// Same rotation as matrix4x4::ScaleYawPitchRollTranslate: rotate = {yaw, pitch, roll}
+        ARKXMM_API RotationYawPitchRoll(Vec3 rotate) noexcept -> Quaternion
+        {
+            auto half = arkxmm::to_array(rotate.v * 0.5f);
+            auto yaw = Quaternion(0.0f, std::sinf(half[0]), 0.0f, std::cosf(half[0]));
+            auto pitch = Quaternion(std::sinf(half[1]), 0.0f, 0.0f, std::cosf(half[1]));
+            auto roll = Quaternion(0.0f, 0.0f, std::sinf(half[2]), std::cosf(half[2]));
+            return roll * pitch * yaw;
+        }
+    }
+
+    namespace matrix4x4
+    {
+        ARKXMM_API ScaleRotateTranslate(Vec3 scale, Quaternion rotation, Vec3 translate) noexcept -> Matrix4x4
+        {
+            auto q = arkxmm::to_array(rotation.v);
+            auto s = arkxmm::to_array(scale.v);
+            float x = q[0], y = q[1], z = q[2], w = q[3];
+            return Matrix4x4(
+                (1.0f - 2.0f * (y * y + z * z)) * s[0], 2.0f * (x * y + w * z) * s[0], 2.0f * (x * z - w * y) * s[0], 0.0f,
+                2.0f * (x * y - w * z) * s[1], (1.0f - 2.0f * (x * x + z * z)) * s[1], 2.0f * (y * z + w * x) * s[1], 0.0f,
+                2.0f * (x * z + w * y) * s[2], 2.0f * (y * z - w * x) * s[2], (1.0f - 2.0f * (x * x + y * y)) * s[2], 0.0f,
+                translate.x(), translate.y(), translate.z(), 1.0f);
+        }
+
+        ARKXMM_API Rotate(Quaternion rotation) noexcept -> Matrix4x4
+        {
+            return ScaleRotateTranslate(Vec3{1.0f, 1.0f, 1.0f}, rotation, Vec3{});
+        }
+    }
+
+    // Batch builder: dst[i] = ScaleRotateTranslate(scale[i], rotation[i], translate[i]), 8 per iteration.
+    void scale_rotate_translate(const Vec3 scale[], const Quaternion rotation[], const Vec3 translate[], Matrix4x4 dst[], size_t count) noexcept;
+
+#pragma endregion
+
+#pragma region Affine2D
+
+    /// 2D affine transform for row vectors: {x', y'} = {x, y, 1} * {{m00, m01}, {m10, m11}, {m20, m21}}.
+    /// 24 bytes per instance instead of 64 for Matrix4x4. Default constructed as identity.
+    struct Affine2D
+    {
+        float m00 = 1.0f, m01 = 0.0f;
+        float m10 = 0.0f, m11 = 1.0f;
+        float m20 = 0.0f, m21 = 0.0f; // translation
+
+        [[nodiscard]] arkxmm::vf32x4 linear() const noexcept { return arkxmm::load_u<arkxmm::vf32x4>(&m00); }                                          // {m00, m01, m10, m11}
+        [[nodiscard]] arkxmm::vf32x4 translation() const noexcept { return arkxmm::vf32x4{_mm_castpd_ps(_mm_load_sd(reinterpret_cast<const double*>(&m20)))}; } // {m20, m21, 0, 0}
+
+        /// Stores linear {m00, m01, m10, m11} and the lower half of translation {m20, m21, _, _}.
+        void store(arkxmm::vf32x4 linear, arkxmm::vf32x4 translation) noexcept
+        {
+            arkxmm::store_u<arkxmm::vf32x4>(&m00, linear);
+            _mm_store_sd(reinterpret_cast<double*>(&m20), _mm_castps_pd(translation.v));
+        }
+    };
+
+    static_assert(std::is_trivially_copyable_v<Affine2D> && sizeof(Affine2D) == 24);
+
+    namespace detail
+    {
+        // Affine2D kernels on each 128-bit lane of V: {m00, m01, m10, m11} and translation {m20, m21, _, _}.
+
+        template <class V>
+        ARKXMM_API affine2d_multiply(V al, V at, V bl, V bt, V& rl, V& rt) noexcept -> void
+        {
+            using arkxmm::shuffle;
+            V b0 = shuffle<0, 1, 0, 1>(bl);
+            V b1 = shuffle<2, 3, 2, 3>(bl);
+            rl = shuffle<0, 0, 2, 2>(al) * b0 + shuffle<1, 1, 3, 3>(al) * b1;
+            rt = shuffle<0, 0, 0, 0>(at) * b0 + shuffle<1, 1, 1, 1>(at) * b1 + bt;
+        }
+
+        template <class V>
+        ARKXMM_API affine2d_inverse(V l, V t, V& rl, V& rt) noexcept -> void
+        {
+            using arkxmm::shuffle;
+            V p = l * shuffle<3, 2, 1, 0>(l); // {m00 m11, m01 m10, ...}
+            V det = shuffle<0, 0, 0, 0>(p) - shuffle<1, 1, 1, 1>(p);
+            rl = shuffle<3, 1, 2, 0>(l) * lanes<V>(arkxmm::f32x4(1.0f, -1.0f, -1.0f, 1.0f)) / det;
+            rt = shuffle<0, 0, 0, 0>(t) * shuffle<0, 1, 0, 1>(rl) + shuffle<1, 1, 1, 1>(t) * shuffle<2, 3, 2, 3>(rl);
+            rt = rt * -1.0f;
+        }
+    }
+
+    /// Composes transforms: a then b (same order as Matrix4x4 product).
+    ARKXMM_API operator *(const Affine2D& a, const Affine2D& b) noexcept -> Affine2D
+    {
+        arkxmm::vf32x4 l, t;
+        detail::affine2d_multiply(a.linear(), a.translation(), b.linear(), b.translation(), l, t);
+        Affine2D r;
+        r.store(l, t);
+        return r;
+    }
+
+    ARKXMM_API operator *=(Affine2D& a, const Affine2D& b) noexcept -> Affine2D& { return a = a * b; }
+
+    ARKXMM_API inverse(const Affine2D& a) noexcept -> Affine2D
+    {
+        arkxmm::vf32x4 l, t;
+        detail::affine2d_inverse(a.linear(), a.translation(), l, t);
+        Affine2D r;
+        r.store(l, t);
+        return r;
+    }
+
+    /// Transforms point; result is {x', y', 0, 0}.
+    ARKXMM_API transform(Vec2 p, const Affine2D& m) noexcept -> Vec2
+    {
+        using arkxmm::shuffle;
+        auto l = m.linear();
+        auto zero = arkxmm::zero<arkxmm::vf32x4>();
+        return Vec2{shuffle<0, 0, 0, 0>(p.v) * shuffle<0, 1, 0, 1>(l, zero) + shuffle<1, 1, 1, 1>(p.v) * shuffle<2, 3, 2, 3>(l, zero) + m.translation()};
+    }
+
+    /// Lossless conversion: {{m00, m01, 0, 0}, {m10, m11, 0, 0}, {0, 0, 1, 0}, {m20, m21, 0, 1}}
+    ARKXMM_API to_matrix4x4(const Affine2D& a) noexcept -> Matrix4x4
+    {
+        using arkxmm::shuffle;
+        auto l = a.linear();
+        auto zero = arkxmm::zero<arkxmm::vf32x4>();
+        return Matrix4x4{
+            shuffle<0, 1, 0, 1>(l, zero),
+            shuffle<2, 3, 2, 3>(l, zero),
+            arkxmm::f32x4(0.0f, 0.0f, 1.0f, 0.0f),
+            a.translation() + arkxmm::f32x4(0.0f, 0.0f, 0.0f, 1.0f),
+        };
+    }
+
+    // Batch operations, 2 transforms per iteration. a/src and dst may be the same array.
+    void multiply(const Affine2D a[], const Affine2D& b, Affine2D dst[], size_t count) noexcept; // dst[i] = a[i] * b
+    void inverse(const Affine2D src[], Affine2D dst[], size_t count) noexcept;
+    void to_matrix4x4(const Affine2D src[], Matrix4x4 dst[], size_t count) noexcept;
+
+    // Batch transform: dst[i] = transform(src[i], m), 8 points per iteration. src and dst may be the same array.
+    void transform_points(const Affine2D& m, const Vec2 src[], Vec2 dst[], size_t count) noexcept;
+
+    namespace affine2d
+    {
+        static constexpr auto Identity() noexcept -> Affine2D { return {}; }
+
+        ARKXMM_API Translate(Vec2 translate) noexcept -> Affine2D
+        {
+            return Affine2D{1.0f, 0.0f, 0.0f, 1.0f, translate.x(), translate.y()};
+        }
+
+        ARKXMM_API ScaleTranslate(Vec2 scale, Vec2 translate) noexcept -> Affine2D
+        {
+            return Affine2D{scale.x(), 0.0f, 0.0f, scale.y(), translate.x(), translate.y()};
+        }
+
+        ARKXMM_API ScaleRollTranslate(Vec2 scale, float roll, Vec2 translate) noexcept -> Affine2D
+        {
+            float cos = std::cosf(roll);
+            float sin = std::sinf(roll);
+            return Affine2D{cos * scale.x(), sin * scale.x(), -sin * scale.y(), cos * scale.y(), translate.x(), translate.y()};
         }
     }
 
@@ -351,8 +810,8 @@ namespace sandy
     {
         arkxmm::vf32x4 value{};
 
-        Color4(arkxmm::vf32x4 v = arkxmm::zero<arkxmm::vf32x4>()) noexcept : value{v} { }
-        Color4(float r, float g, float b, float a = 1.0f) noexcept : value{arkxmm::f32x4(r, g, b, a)} { }
+        constexpr Color4(arkxmm::vf32x4 v = detail::constant_f32x4(0.0f, 0.0f, 0.0f, 0.0f)) noexcept : value{v} { }
+        constexpr Color4(float r, float g, float b, float a = 1.0f) noexcept : value{detail::constant_f32x4(r, g, b, a)} { }
 
         [[nodiscard]] float r() const noexcept { return arkxmm::extract_element<0>(value); }
         [[nodiscard]] float g() const noexcept { return arkxmm::extract_element<1>(value); }
@@ -365,7 +824,7 @@ namespace sandy
         [[nodiscard]] Color4 with_blue(float b) const noexcept { return Color4{arkxmm::insert_element<2>(value, b)}; }
         [[nodiscard]] Color4 with_alpha(float a) const noexcept { return Color4{arkxmm::insert_element<3>(value, a)}; }
 
-        [[nodiscard]] static Color4 from_rgb(uint32_t rgb) noexcept
+        [[nodiscard]] static constexpr Color4 from_rgb(uint32_t rgb) noexcept
         {
             return Color4{
                 static_cast<float>(rgb >> 16 & 0xff) / 255.0f,
@@ -375,7 +834,7 @@ namespace sandy
             };
         }
 
-        [[nodiscard]] static Color4 from_argb(uint32_t rgb) noexcept
+        [[nodiscard]] static constexpr Color4 from_argb(uint32_t rgb) noexcept
         {
             return Color4{
                 static_cast<float>(rgb >> 16 & 0xff) / 255.0f,
@@ -398,155 +857,231 @@ namespace sandy
 
     namespace colors
     {
-        static inline Color4 MakeGray(float g, float a = 1.0f) { return Color4(g, g, g, a); }
-        static const inline Color4 Transparent = MakeGray(0.0f, 0.0f);
-        static const inline Color4 TransparentBlack = MakeGray(0.0f, 0.0f);
-        static const inline Color4 TransparentWhite = MakeGray(1.0f, 0.0f);
-        static inline Color4 FromRGB(uint32_t rgb) { return Color4::from_rgb(rgb); }
-        static inline Color4 FromARGB(uint32_t rgb) { return Color4::from_argb(rgb); }
-
-        static const inline Color4 AliceBlue = Color4::from_rgb(0xF0F8FF);
-        static const inline Color4 AntiqueWhite = Color4::from_rgb(0xFAEBD7);
-        static const inline Color4 Aqua = Color4::from_rgb(0x00FFFF);
-        static const inline Color4 Aquamarine = Color4::from_rgb(0x7FFFD4);
-        static const inline Color4 Azure = Color4::from_rgb(0xF0FFFF);
-        static const inline Color4 Beige = Color4::from_rgb(0xF5F5DC);
-        static const inline Color4 Bisque = Color4::from_rgb(0xFFE4C4);
-        static const inline Color4 Black = Color4::from_rgb(0x000000);
-        static const inline Color4 BlanchedAlmond = Color4::from_rgb(0xFFEBCD);
-        static const inline Color4 Blue = Color4::from_rgb(0x0000FF);
-        static const inline Color4 BlueViolet = Color4::from_rgb(0x8A2BE2);
-        static const inline Color4 Brown = Color4::from_rgb(0xA52A2A);
-        static const inline Color4 BurlyWood = Color4::from_rgb(0xDEB887);
-        static const inline Color4 CadetBlue = Color4::from_rgb(0x5F9EA0);
-        static const inline Color4 Chartreuse = Color4::from_rgb(0x7FFF00);
-        static const inline Color4 Chocolate = Color4::from_rgb(0xD2691E);
-        static const inline Color4 Coral = Color4::from_rgb(0xFF7F50);
-        static const inline Color4 CornflowerBlue = Color4::from_rgb(0x6495ED);
-        static const inline Color4 Cornsilk = Color4::from_rgb(0xFFF8DC);
-        static const inline Color4 Crimson = Color4::from_rgb(0xDC143C);
-        static const inline Color4 Cyan = Color4::from_rgb(0x00FFFF);
-        static const inline Color4 DarkBlue = Color4::from_rgb(0x00008B);
-        static const inline Color4 DarkCyan = Color4::from_rgb(0x008B8B);
-        static const inline Color4 DarkGoldenRod = Color4::from_rgb(0xB8860B);
-        static const inline Color4 DarkGray = Color4::from_rgb(0xA9A9A9);
-        static const inline Color4 DarkGreen = Color4::from_rgb(0x006400);
-        static const inline Color4 DarkKhaki = Color4::from_rgb(0xBDB76B);
-        static const inline Color4 DarkMagenta = Color4::from_rgb(0x8B008B);
-        static const inline Color4 DarkOliveGreen = Color4::from_rgb(0x556B2F);
-        static const inline Color4 DarkOrange = Color4::from_rgb(0xFF8C00);
-        static const inline Color4 DarkOrchid = Color4::from_rgb(0x9932CC);
-        static const inline Color4 DarkRed = Color4::from_rgb(0x8B0000);
-        static const inline Color4 DarkSalmon = Color4::from_rgb(0xE9967A);
-        static const inline Color4 DarkSeaGreen = Color4::from_rgb(0x8FBC8F);
-        static const inline Color4 DarkSlateBlue = Color4::from_rgb(0x483D8B);
-        static const inline Color4 DarkSlateGray = Color4::from_rgb(0x2F4F4F);
-        static const inline Color4 DarkTurquoise = Color4::from_rgb(0x00CED1);
-        static const inline Color4 DarkViolet = Color4::from_rgb(0x9400D3);
-        static const inline Color4 DeepPink = Color4::from_rgb(0xFF1493);
-        static const inline Color4 DeepSkyBlue = Color4::from_rgb(0x00BFFF);
-        static const inline Color4 DimGray = Color4::from_rgb(0x696969);
-        static const inline Color4 DodgerBlue = Color4::from_rgb(0x1E90FF);
-        static const inline Color4 FireBrick = Color4::from_rgb(0xB22222);
-        static const inline Color4 FloralWhite = Color4::from_rgb(0xFFFAF0);
-        static const inline Color4 ForestGreen = Color4::from_rgb(0x228B22);
-        static const inline Color4 Fuchsia = Color4::from_rgb(0xFF00FF);
-        static const inline Color4 Gainsboro = Color4::from_rgb(0xDCDCDC);
-        static const inline Color4 GhostWhite = Color4::from_rgb(0xF8F8FF);
-        static const inline Color4 Gold = Color4::from_rgb(0xFFD700);
-        static const inline Color4 GoldenRod = Color4::from_rgb(0xDAA520);
-        static const inline Color4 Gray = Color4::from_rgb(0x808080);
-        static const inline Color4 Green = Color4::from_rgb(0x008000);
-        static const inline Color4 GreenYellow = Color4::from_rgb(0xADFF2F);
-        static const inline Color4 HoneyDew = Color4::from_rgb(0xF0FFF0);
-        static const inline Color4 HotPink = Color4::from_rgb(0xFF69B4);
-        static const inline Color4 IndianRed = Color4::from_rgb(0xCD5C5C);
-        static const inline Color4 Indigo = Color4::from_rgb(0x4B0082);
-        static const inline Color4 Ivory = Color4::from_rgb(0xFFFFF0);
-        static const inline Color4 Khaki = Color4::from_rgb(0xF0E68C);
-        static const inline Color4 Lavender = Color4::from_rgb(0xE6E6FA);
-        static const inline Color4 LavenderBlush = Color4::from_rgb(0xFFF0F5);
-        static const inline Color4 LawnGreen = Color4::from_rgb(0x7CFC00);
-        static const inline Color4 LemonChiffon = Color4::from_rgb(0xFFFACD);
-        static const inline Color4 LightBlue = Color4::from_rgb(0xADD8E6);
-        static const inline Color4 LightCoral = Color4::from_rgb(0xF08080);
-        static const inline Color4 LightCyan = Color4::from_rgb(0xE0FFFF);
-        static const inline Color4 LightGoldenRodYellow = Color4::from_rgb(0xFAFAD2);
-        static const inline Color4 LightGray = Color4::from_rgb(0xD3D3D3);
-        static const inline Color4 LightGreen = Color4::from_rgb(0x90EE90);
-        static const inline Color4 LightPink = Color4::from_rgb(0xFFB6C1);
-        static const inline Color4 LightSalmon = Color4::from_rgb(0xFFA07A);
-        static const inline Color4 LightSeaGreen = Color4::from_rgb(0x20B2AA);
-        static const inline Color4 LightSkyBlue = Color4::from_rgb(0x87CEFA);
-        static const inline Color4 LightSlateGray = Color4::from_rgb(0x778899);
-        static const inline Color4 LightSteelBlue = Color4::from_rgb(0xB0C4DE);
-        static const inline Color4 LightYellow = Color4::from_rgb(0xFFFFE0);
-        static const inline Color4 Lime = Color4::from_rgb(0x00FF00);
-        static const inline Color4 LimeGreen = Color4::from_rgb(0x32CD32);
-        static const inline Color4 Linen = Color4::from_rgb(0xFAF0E6);
-        static const inline Color4 Magenta = Color4::from_rgb(0xFF00FF);
-        static const inline Color4 Maroon = Color4::from_rgb(0x800000);
-        static const inline Color4 MediumAquaMarine = Color4::from_rgb(0x66CDAA);
-        static const inline Color4 MediumBlue = Color4::from_rgb(0x0000CD);
-        static const inline Color4 MediumOrchid = Color4::from_rgb(0xBA55D3);
-        static const inline Color4 MediumPurple = Color4::from_rgb(0x9370DB);
-        static const inline Color4 MediumSeaGreen = Color4::from_rgb(0x3CB371);
-        static const inline Color4 MediumSlateBlue = Color4::from_rgb(0x7B68EE);
-        static const inline Color4 MediumSpringGreen = Color4::from_rgb(0x00FA9A);
-        static const inline Color4 MediumTurquoise = Color4::from_rgb(0x48D1CC);
-        static const inline Color4 MediumVioletRed = Color4::from_rgb(0xC71585);
-        static const inline Color4 MidnightBlue = Color4::from_rgb(0x191970);
-        static const inline Color4 MintCream = Color4::from_rgb(0xF5FFFA);
-        static const inline Color4 MistyRose = Color4::from_rgb(0xFFE4E1);
-        static const inline Color4 Moccasin = Color4::from_rgb(0xFFE4B5);
-        static const inline Color4 NavajoWhite = Color4::from_rgb(0xFFDEAD);
-        static const inline Color4 Navy = Color4::from_rgb(0x000080);
-        static const inline Color4 OldLace = Color4::from_rgb(0xFDF5E6);
-        static const inline Color4 Olive = Color4::from_rgb(0x808000);
-        static const inline Color4 OliveDrab = Color4::from_rgb(0x6B8E23);
-        static const inline Color4 Orange = Color4::from_rgb(0xFFA500);
-        static const inline Color4 OrangeRed = Color4::from_rgb(0xFF4500);
-        static const inline Color4 Orchid = Color4::from_rgb(0xDA70D6);
-        static const inline Color4 PaleGoldenRod = Color4::from_rgb(0xEEE8AA);
-        static const inline Color4 PaleGreen = Color4::from_rgb(0x98FB98);
-        static const inline Color4 PaleTurquoise = Color4::from_rgb(0xAFEEEE);
-        static const inline Color4 PaleVioletRed = Color4::from_rgb(0xDB7093);
-        static const inline Color4 PapayaWhip = Color4::from_rgb(0xFFEFD5);
-        static const inline Color4 PeachPuff = Color4::from_rgb(0xFFDAB9);
-        static const inline Color4 Peru = Color4::from_rgb(0xCD853F);
-        static const inline Color4 Pink = Color4::from_rgb(0xFFC0CB);
-        static const inline Color4 Plum = Color4::from_rgb(0xDDA0DD);
-        static const inline Color4 PowderBlue = Color4::from_rgb(0xB0E0E6);
-        static const inline Color4 Purple = Color4::from_rgb(0x800080);
-        static const inline Color4 RebeccaPurple = Color4::from_rgb(0x663399);
-        static const inline Color4 Red = Color4::from_rgb(0xFF0000);
-        static const inline Color4 RosyBrown = Color4::from_rgb(0xBC8F8F);
-        static const inline Color4 RoyalBlue = Color4::from_rgb(0x4169E1);
-        static const inline Color4 SaddleBrown = Color4::from_rgb(0x8B4513);
-        static const inline Color4 Salmon = Color4::from_rgb(0xFA8072);
-        static const inline Color4 SandyBrown = Color4::from_rgb(0xF4A460);
-        static const inline Color4 SeaGreen = Color4::from_rgb(0x2E8B57);
-        static const inline Color4 SeaShell = Color4::from_rgb(0xFFF5EE);
-        static const inline Color4 Sienna = Color4::from_rgb(0xA0522D);
-        static const inline Color4 Silver = Color4::from_rgb(0xC0C0C0);
-        static const inline Color4 SkyBlue = Color4::from_rgb(0x87CEEB);
-        static const inline Color4 SlateBlue = Color4::from_rgb(0x6A5ACD);
-        static const inline Color4 SlateGray = Color4::from_rgb(0x708090);
-        static const inline Color4 Snow = Color4::from_rgb(0xFFFAFA);
-        static const inline Color4 SpringGreen = Color4::from_rgb(0x00FF7F);
-        static const inline Color4 SteelBlue = Color4::from_rgb(0x4682B4);
-        static const inline Color4 Tan = Color4::from_rgb(0xD2B48C);
-        static const inline Color4 Teal = Color4::from_rgb(0x008080);
-        static const inline Color4 Thistle = Color4::from_rgb(0xD8BFD8);
-        static const inline Color4 Tomato = Color4::from_rgb(0xFF6347);
-        static const inline Color4 Turquoise = Color4::from_rgb(0x40E0D0);
-        static const inline Color4 Violet = Color4::from_rgb(0xEE82EE);
-        static const inline Color4 Wheat = Color4::from_rgb(0xF5DEB3);
-        static const inline Color4 White = Color4::from_rgb(0xFFFFFF);
-        static const inline Color4 WhiteSmoke = Color4::from_rgb(0xF5F5F5);
-        static const inline Color4 Yellow = Color4::from_rgb(0xFFFF00);
-        static const inline Color4 YellowGreen = Color4::from_rgb(0x9ACD32);
+        static constexpr Color4 MakeGray(float g, float a = 1.0f) { return Color4(g, g, g, a); }
+        static constexpr inline Color4 Transparent = MakeGray(0.0f, 0.0f);
+        static constexpr inline Color4 TransparentBlack = MakeGray(0.0f, 0.0f);
+        static constexpr inline Color4 TransparentWhite = MakeGray(1.0f, 0.0f);
+        static constexpr Color4 FromRGB(uint32_t rgb) { return Color4::from_rgb(rgb); }
+        static constexpr Color4 FromARGB(uint32_t rgb) { return Color4::from_argb(rgb); }
+
+        static constexpr inline Color4 AliceBlue = Color4::from_rgb(0xF0F8FF);
+        static constexpr inline Color4 AntiqueWhite = Color4::from_rgb(0xFAEBD7);
+        static constexpr inline Color4 Aqua = Color4::from_rgb(0x00FFFF);
+        static constexpr inline Color4 Aquamarine = Color4::from_rgb(0x7FFFD4);
+        static constexpr inline Color4 Azure = Color4::from_rgb(0xF0FFFF);
+        static constexpr inline Color4 Beige = Color4::from_rgb(0xF5F5DC);
+        static constexpr inline Color4 Bisque = Color4::from_rgb(0xFFE4C4);
+        static constexpr inline Color4 Black = Color4::from_rgb(0x000000);
+        static constexpr inline Color4 BlanchedAlmond = Color4::from_rgb(0xFFEBCD);
+        static constexpr inline Color4 Blue = Color4::from_rgb(0x0000FF);
+        static constexpr inline Color4 BlueViolet = Color4::from_rgb(0x8A2BE2);
+        static constexpr inline Color4 Brown = Color4::from_rgb(0xA52A2A);
+        static constexpr inline Color4 BurlyWood = Color4::from_rgb(0xDEB887);
+        static constexpr inline Color4 CadetBlue = Color4::from_rgb(0x5F9EA0);
+        static constexpr inline Color4 Chartreuse = Color4::from_rgb(0x7FFF00);
+        static constexpr inline Color4 Chocolate = Color4::from_rgb(0xD2691E);
+        static constexpr inline Color4 Coral = Color4::from_rgb(0xFF7F50);
+        static constexpr inline Color4 CornflowerBlue = Color4::from_rgb(0x6495ED);
+        static constexpr inline Color4 Cornsilk = Color4::from_rgb(0xFFF8DC);
+        static constexpr inline Color4 Crimson = Color4::from_rgb(0xDC143C);
+        static constexpr inline Color4 Cyan = Color4::from_rgb(0x00FFFF);
+        static constexpr inline Color4 DarkBlue = Color4::from_rgb(0x00008B);
+        static constexpr inline Color4 DarkCyan = Color4::from_rgb(0x008B8B);
+        static constexpr inline Color4 DarkGoldenRod = Color4::from_rgb(0xB8860B);
+        static constexpr inline Color4 DarkGray = Color4::from_rgb(0xA9A9A9);
+        static constexpr inline Color4 DarkGreen = Color4::from_rgb(0x006400);
+        static constexpr inline Color4 DarkKhaki = Color4::from_rgb(0xBDB76B);
+        static constexpr inline Color4 DarkMagenta = Color4::from_rgb(0x8B008B);
+        static constexpr inline Color4 DarkOliveGreen = Color4::from_rgb(0x556B2F);
+        static constexpr inline Color4 DarkOrange = Color4::from_rgb(0xFF8C00);
+        static constexpr inline Color4 DarkOrchid = Color4::from_rgb(0x9932CC);
+        static constexpr inline Color4 DarkRed = Color4::from_rgb(0x8B0000);
+        static constexpr inline Color4 DarkSalmon = Color4::from_rgb(0xE9967A);
+        static constexpr inline Color4 DarkSeaGreen = Color4::from_rgb(0x8FBC8F);
+        static constexpr inline Color4 DarkSlateBlue = Color4::from_rgb(0x483D8B);
+        static constexpr inline Color4 DarkSlateGray = Color4::from_rgb(0x2F4F4F);
+        static constexpr inline Color4 DarkTurquoise = Color4::from_rgb(0x00CED1);
+        static constexpr inline Color4 DarkViolet = Color4::from_rgb(0x9400D3);
+        static constexpr inline Color4 DeepPink = Color4::from_rgb(0xFF1493);
+        static constexpr inline Color4 DeepSkyBlue = Color4::from_rgb(0x00BFFF);
+        static constexpr inline Color4 DimGray = Color4::from_rgb(0x696969);
+        static constexpr inline Color4 DodgerBlue = Color4::from_rgb(0x1E90FF);
+        static constexpr inline Color4 FireBrick = Color4::from_rgb(0xB22222);
+        static constexpr inline Color4 FloralWhite = Color4::from_rgb(0xFFFAF0);
+        static constexpr inline Color4 ForestGreen = Color4::from_rgb(0x228B22);
+        static constexpr inline Color4 Fuchsia = Color4::from_rgb(0xFF00FF);
+        static constexpr inline Color4 Gainsboro = Color4::from_rgb(0xDCDCDC);
+        static constexpr inline Color4 GhostWhite = Color4::from_rgb(0xF8F8FF);
+        static constexpr inline Color4 Gold = Color4::from_rgb(0xFFD700);
+        static constexpr inline Color4 GoldenRod = Color4::from_rgb(0xDAA520);
+        static constexpr inline Color4 Gray = Color4::from_rgb(0x808080);
+        static constexpr inline Color4 Green = Color4::from_rgb(0x008000);
+        static constexpr inline Color4 GreenYellow = Color4::from_rgb(0xADFF2F);
+        static constexpr inline Color4 HoneyDew = Color4::from_rgb(0xF0FFF0);
+        static constexpr inline Color4 HotPink = Color4::from_rgb(0xFF69B4);
+        static constexpr inline Color4 IndianRed = Color4::from_rgb(0xCD5C5C);
+        static constexpr inline Color4 Indigo = Color4::from_rgb(0x4B0082);
+        static constexpr inline Color4 Ivory = Color4::from_rgb(0xFFFFF0);
+        static constexpr inline Color4 Khaki = Color4::from_rgb(0xF0E68C);
+        static constexpr inline Color4 Lavender = Color4::from_rgb(0xE6E6FA);
+        static constexpr inline Color4 LavenderBlush = Color4::from_rgb(0xFFF0F5);
+        static constexpr inline Color4 LawnGreen = Color4::from_rgb(0x7CFC00);
+        static constexpr inline Color4 LemonChiffon = Color4::from_rgb(0xFFFACD);
+        static constexpr inline Color4 LightBlue = Color4::from_rgb(0xADD8E6);
+        static constexpr inline Color4 LightCoral = Color4::from_rgb(0xF08080);
+        static constexpr inline Color4 LightCyan = Color4::from_rgb(0xE0FFFF);
+        static constexpr inline Color4 LightGoldenRodYellow = Color4::from_rgb(0xFAFAD2);
+        static constexpr inline Color4 LightGray = Color4::from_rgb(0xD3D3D3);
+        static constexpr inline Color4 LightGreen = Color4::from_rgb(0x90EE90);
+        static constexpr inline Color4 LightPink = Color4::from_rgb(0xFFB6C1);
+        static constexpr inline Color4 LightSalmon = Color4::from_rgb(0xFFA07A);
+        static constexpr inline Color4 LightSeaGreen = Color4::from_rgb(0x20B2AA);
+        static constexpr inline Color4 LightSkyBlue = Color4::from_rgb(0x87CEFA);
+        static constexpr inline Color4 LightSlateGray = Color4::from_rgb(0x778899);
+        static constexpr inline Color4 LightSteelBlue = Color4::from_rgb(0xB0C4DE);
+        static constexpr inline Color4 LightYellow = Color4::from_rgb(0xFFFFE0);
+        static constexpr inline Color4 Lime = Color4::from_rgb(0x00FF00);
+        static constexpr inline Color4 LimeGreen = Color4::from_rgb(0x32CD32);
+        static constexpr inline Color4 Linen = Color4::from_rgb(0xFAF0E6);
+        static constexpr inline Color4 Magenta = Color4::from_rgb(0xFF00FF);
+        static constexpr inline Color4 Maroon = Color4::from_rgb(0x800000);
+        static constexpr inline Color4 MediumAquaMarine = Color4::from_rgb(0x66CDAA);
+        static constexpr inline Color4 MediumBlue = Color4::from_rgb(0x0000CD);
+        static constexpr inline Color4 MediumOrchid = Color4::from_rgb(0xBA55D3);
+        static constexpr inline Color4 MediumPurple = Color4::from_rgb(0x9370DB);
+        static constexpr inline Color4 MediumSeaGreen = Color4::from_rgb(0x3CB371);
+        static constexpr inline Color4 MediumSlateBlue = Color4::from_rgb(0x7B68EE);
+        static constexpr inline Color4 MediumSpringGreen = Color4::from_rgb(0x00FA9A);
+        static constexpr inline Color4 MediumTurquoise = Color4::from_rgb(0x48D1CC);
+        static constexpr inline Color4 MediumVioletRed = Color4::from_rgb(0xC71585);
+        static constexpr inline Color4 MidnightBlue = Color4::from_rgb(0x191970);
+        static constexpr inline Color4 MintCream = Color4::from_rgb(0xF5FFFA);
+        static constexpr inline Color4 MistyRose = Color4::from_rgb(0xFFE4E1);
+        static constexpr inline Color4 Moccasin = Color4::from_rgb(0xFFE4B5);
+        static constexpr inline Color4 NavajoWhite = Color4::from_rgb(0xFFDEAD);
+        static constexpr inline Color4 Navy = Color4::from_rgb(0x000080);
+        static constexpr inline Color4 OldLace = Color4::from_rgb(0xFDF5E6);
+        static constexpr inline Color4 Olive = Color4::from_rgb(0x808000);
+        static constexpr inline Color4 OliveDrab = Color4::from_rgb(0x6B8E23);
+        static constexpr inline Color4 Orange = Color4::from_rgb(0xFFA500);
+        static constexpr inline Color4 OrangeRed = Color4::from_rgb(0xFF4500);
+        static constexpr inline Color4 Orchid = Color4::from_rgb(0xDA70D6);
+        static constexpr inline Color4 PaleGoldenRod = Color4::from_rgb(0xEEE8AA);
+        static constexpr inline Color4 PaleGreen = Color4::from_rgb(0x98FB98);
+        static constexpr inline Color4 PaleTurquoise = Color4::from_rgb(0xAFEEEE);
+        static constexpr inline Color4 PaleVioletRed = Color4::from_rgb(0xDB7093);
+        static constexpr inline Color4 PapayaWhip = Color4::from_rgb(0xFFEFD5);
+        static constexpr inline Color4 PeachPuff = Color4::from_rgb(0xFFDAB9);
+        static constexpr inline Color4 Peru = Color4::from_rgb(0xCD853F);
+        static constexpr inline Color4 Pink = Color4::from_rgb(0xFFC0CB);
+        static constexpr inline Color4 Plum = Color4::from_rgb(0xDDA0DD);
+        static constexpr inline Color4 PowderBlue = Color4::from_rgb(0xB0E0E6);
+        static constexpr inline Color4 Purple = Color4::from_rgb(0x800080);
+        static constexpr inline Color4 RebeccaPurple = Color4::from_rgb(0x663399);
+        static constexpr inline Color4 Red = Color4::from_rgb(0xFF0000);
+        static constexpr inline Color4 RosyBrown = Color4::from_rgb(0xBC8F8F);
+        static constexpr inline Color4 RoyalBlue = Color4::from_rgb(0x4169E1);
+        static constexpr inline Color4 SaddleBrown = Color4::from_rgb(0x8B4513);
+        static constexpr inline Color4 Salmon = Color4::from_rgb(0xFA8072);
+        static constexpr inline Color4 SandyBrown = Color4::from_rgb(0xF4A460);
+        static constexpr inline Color4 SeaGreen = Color4::from_rgb(0x2E8B57);
+        static constexpr inline Color4 SeaShell = Color4::from_rgb(0xFFF5EE);
+        static constexpr inline Color4 Sienna = Color4::from_rgb(0xA0522D);
+        static constexpr inline Color4 Silver = Color4::from_rgb(0xC0C0C0);
+        static constexpr inline Color4 SkyBlue = Color4::from_rgb(0x87CEEB);
+        static constexpr inline Color4 SlateBlue = Color4::from_rgb(0x6A5ACD);
+        static constexpr inline Color4 SlateGray = Color4::from_rgb(0x708090);
+        static constexpr inline Color4 Snow = Color4::from_rgb(0xFFFAFA);
+        static constexpr inline Color4 SpringGreen = Color4::from_rgb(0x00FF7F);
+        static constexpr inline Color4 SteelBlue = Color4::from_rgb(0x4682B4);
+        static constexpr inline Color4 Tan = Color4::from_rgb(0xD2B48C);
+        static constexpr inline Color4 Teal = Color4::from_rgb(0x008080);
+        static constexpr inline Color4 Thistle = Color4::from_rgb(0xD8BFD8);
+        static constexpr inline Color4 Tomato = Color4::from_rgb(0xFF6347);
+        static constexpr inline Color4 Turquoise = Color4::from_rgb(0x40E0D0);
+        static constexpr inline Color4 Violet = Color4::from_rgb(0xEE82EE);
+        static constexpr inline Color4 Wheat = Color4::from_rgb(0xF5DEB3);
+        static constexpr inline Color4 White = Color4::from_rgb(0xFFFFFF);
+        static constexpr inline Color4 WhiteSmoke = Color4::from_rgb(0xF5F5F5);
+        static constexpr inline Color4 Yellow = Color4::from_rgb(0xFFFF00);
+        static constexpr inline Color4 YellowGreen = Color4::from_rgb(0x9ACD32);
+    }
+
+    /// Byte order of packed 8-bit colors in memory (DXGI naming).
+    /// Bgra reads as 0xAARRGGBB through uint32_t, the from_argb layout.
+    enum struct ColorByteOrder
+    {
+        Rgba, // R8G8B8A8
+        Bgra, // B8G8R8A8
+        Argb, // A8R8G8B8
+    };
+
+    /// Packs to 8-bit unorm with rounding; components are clamped to [0, 1].
+    static inline uint32_t pack_color(Color4 c, ColorByteOrder order) noexcept
+    {
+        auto v = arkxmm::to_array(arkxmm::min(arkxmm::max(c.value, 0.0f), 1.0f) * 255.0f + 0.5f);
+        uint32_t r = static_cast<uint32_t>(v[0]), g = static_cast<uint32_t>(v[1]), b = static_cast<uint32_t>(v[2]), a = static_cast<uint32_t>(v[3]);
+        switch (order)
+        {
+        case ColorByteOrder::Rgba: return r | g << 8 | b << 16 | a << 24;
+        case ColorByteOrder::Bgra: return b | g << 8 | r << 16 | a << 24;
+        case ColorByteOrder::Argb: return a | r << 8 | g << 16 | b << 24;
+        }
+        return 0;
     }
+
+    static inline Color4 unpack_color(uint32_t c, ColorByteOrder order) noexcept
+    {
+        switch (order)
+        {
+        case ColorByteOrder::Rgba: return Color4::from_argb((c & 0xFF00FF00) | (c >> 16 & 0xFF) | (c & 0xFF) << 16);
+        case ColorByteOrder::Bgra: return Color4::from_argb(c);
+        case ColorByteOrder::Argb: return Color4::from_argb((c >> 24 & 0xFF) | (c >> 8 & 0xFF00) | (c << 8 & 0xFF0000) | c << 24);
+        }
+        return {};
+    }
+
+    /// sRGB transfer function on r, g, b; alpha is kept.
+    static inline Color4 linear_to_srgb(Color4 c) noexcept
+    {
+        auto f = [](float x) { return x <= 0.0031308f ? x * 12.92f : 1.055f * std::pow(x, 1.0f / 2.4f) - 0.055f; };
+        return Color4{f(c.r()), f(c.g()), f(c.b()), c.a()};
+    }
+
+    static inline Color4 srgb_to_linear(Color4 c) noexcept
+    {
+        auto f = [](float x) { return x <= 0.04045f ? x / 12.92f : std::pow((x + 0.055f) / 1.055f, 2.4f); };
+        return Color4{f(c.r()), f(c.g()), f(c.b()), c.a()};
+    }
+
+    static inline Color4 premultiply_alpha(Color4 c) noexcept
+    {
+        return Color4{arkxmm::blend<0b1000>(c.value * arkxmm::shuffle<3, 3, 3, 3>(c.value), c.value)};
+    }
+
+    /// Colors with zero alpha become transparent black.
+    static inline Color4 unpremultiply_alpha(Color4 c) noexcept
+    {
+        float a = c.a();
+        return a == 0.0f ? Color4{} : Color4{arkxmm::blend<0b1000>(c.value / a, c.value)};
+    }
+
+    // Batch conversions, 8 colors per iteration. Color4 to Color4 conversions may run in place (src == dst).
+    void pack_colors(const Color4 src[], uint32_t dst[], size_t count, ColorByteOrder order) noexcept;
+    void unpack_colors(const uint32_t src[], Color4 dst[], size_t count, ColorByteOrder order) noexcept;
+    void linear_to_srgb(const Color4 src[], Color4 dst[], size_t count) noexcept; // polynomial pow, |error| < 1e-6 on [0, 1]
+    void srgb_to_linear(const Color4 src[], Color4 dst[], size_t count) noexcept;
+    void premultiply_alpha(const Color4 src[], Color4 dst[], size_t count) noexcept;
+    void unpremultiply_alpha(const Color4 src[], Color4 dst[], size_t count) noexcept;
+#pragma endregion
+
+#pragma region half precision
+
+    // Bulk float <-> IEEE half conversion (round to nearest even), 8 per iteration via arkxmm::convert_cast.
+    // For R16G16(B16A16)_FLOAT vertex/instance streams and HDR textures, pass vector/Color4 arrays as floats: count = elements * 4.
+    void float_to_half(const float src[], arkxmm::float16_t dst[], size_t count) noexcept;
+    void half_to_float(const arkxmm::float16_t src[], float dst[], size_t count) noexcept;
+
 #pragma endregion
 
 #pragma region interpolation functions
@@ -580,7 +1115,7 @@ namespace sandy
         t = std::clamp(t, 0.0f, 1.0f);
         auto t2 = t * t;
         auto t3 = t2 * t;
-        return (2.0f * t * 3.0f - 3.0f * t2 + 1.0f) * pos0 +
+        return (2.0f * t3 - 3.0f * t2 + 1.0f) * pos0 +
             (t3 - 2.0f * t2 + t) * tan0 +
             (-2.0f * t3 + 3.0f * t2) * pos1 +
             (t3 - t2) * tan1;
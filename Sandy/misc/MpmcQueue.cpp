@@ -0,0 +1,5 @@
+/// @file
+///	@brief   sandy::MpmcQueue
+///	@author  (C) 2023 ttsuki
+
+#include "./MpmcQueue.h"
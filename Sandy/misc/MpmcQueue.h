@@ -0,0 +1,358 @@
+/// @file
+///	@brief   sandy::MpmcQueue
+///	@author  (C) 2023 ttsuki
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <atomic>
+#include <memory>
+#include <optional>
+#include <chrono>
+#include <limits>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "./Parking.h"
+#include "./QueueStatistics.h"
+
+namespace sandy
+{
+    /// Bounded lock-free multi-producer/multi-consumer queue with the ConcurrentQueue surface (D. Vyukov's array queue).
+    /// Each slot carries a sequence number telling producers and consumers whose turn it is, so a push or pop is one CAS on
+    /// the shared position plus one release store on the slot. Any number of threads may push and pop concurrently.
+    /// Blocking = true parks waiters on a condition_variable (see Parking); false makes pop_wait/emplace spin-yield instead.
+    template <class T, bool Blocking = true>
+    class MpmcQueue final
+    {
+        static_assert(std::is_nothrow_move_constructible_v<T>, "T must be nothrow move constructible");
+
+        static constexpr size_t cache_line = 64;
+        static constexpr size_t closed_bit = size_t{1} << (sizeof(size_t) * 8 - 1);
+
+        struct Cell
+        {
+            std::atomic<size_t> sequence{};
+            alignas(T) std::byte storage[sizeof(T)];
+        };
+
+        using Parking = std::conditional_t<Blocking, sandy::Parking, SpinParking>;
+
+        const size_t limit_{};
+        const size_t mask_{};
+        std::unique_ptr<Cell[]> cells_{};
+
+        // closed_bit is or-ed into enqueue_pos_ on close(), so a producer's CAS fails once the queue is closed.
+        alignas(cache_line) std::atomic<size_t> enqueue_pos_{};
+        alignas(cache_line) std::atomic<size_t> dequeue_pos_{};
+        alignas(cache_line) Parking can_produce_{};
+        Parking can_consume_{};
+        alignas(cache_line) QueueStatisticsRecorder statistics_{};
+
+        T* element(Cell& cell) noexcept { return std::launder(reinterpret_cast<T*>(cell.storage)); }
+
+        enum struct Push { Done, Full, Closed };
+
+        // T must be nothrow constructible from val: a throw after claiming a slot would leave it unpublished for good.
+        template <class... U>
+        Push push(U&&... val) noexcept
+        {
+            size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+            Cell* cell;
+            for (;;)
+            {
+                if (pos & closed_bit) return Push::Closed;
+                cell = &cells_[pos & mask_];
+                const size_t seq = cell->sequence.load(std::memory_order_acquire);
+                const auto diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+                if (diff == 0)
+                {
+                    // the ring may be larger than limit_: full once limit_ elements are queued. A stale pos below head fails the CAS below.
+                    const size_t head = dequeue_pos_.load(std::memory_order_acquire);
+                    if (static_cast<intptr_t>(pos - head) >= static_cast<intptr_t>(limit_)) return Push::Full;
+                    if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+                }
+                else if (diff < 0)
+                {
+                    return Push::Full; // slot still holds the element from one lap ago
+                }
+                else
+                {
+                    pos = enqueue_pos_.load(std::memory_order_relaxed);
+                }
+            }
+
+            ::new(static_cast<void*>(cell->storage)) T(std::forward<U>(val)...);
+            cell->sequence.store(pos + 1, std::memory_order_release);
+            statistics_.pushed();
+            can_consume_.notify();
+            return Push::Done;
+        }
+
+        std::optional<T> pop_front()
+        {
+            size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+            Cell* cell;
+            for (;;)
+            {
+                cell = &cells_[pos & mask_];
+                const size_t seq = cell->sequence.load(std::memory_order_acquire);
+                const auto diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+                if (diff == 0)
+                {
+                    if (dequeue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+                }
+                else if (diff < 0)
+                {
+                    return std::nullopt; // not published yet
+                }
+                else
+                {
+                    pos = dequeue_pos_.load(std::memory_order_relaxed);
+                }
+            }
+
+            T* p = element(*cell);
+            std::optional<T> ret(std::move(*p));
+            p->~T();
+            cell->sequence.store(pos + mask_ + 1, std::memory_order_release);
+            statistics_.popped();
+            can_produce_.notify();
+            return ret;
+        }
+
+        [[nodiscard]] bool closed_flag() const noexcept
+        {
+            return enqueue_pos_.load(std::memory_order_acquire) & closed_bit;
+        }
+
+        // output iterator dropping what is assigned to it.
+        struct Discard
+        {
+            Discard& operator *() noexcept { return *this; }
+            Discard& operator ++() noexcept { return *this; }
+            template <class V> Discard& operator =(V&&) noexcept { return *this; }
+        };
+
+        // moves up to max published values to out, one slot at a time.
+        template <class OutputIt>
+        size_t take(OutputIt& out, size_t max)
+        {
+            size_t n = 0;
+            for (; n < max; n++)
+            {
+                std::optional<T> value = pop_front();
+                if (!value) { break; }
+                *out = std::move(*value);
+                ++out;
+            }
+            return n;
+        }
+
+    public:
+        /// Holds up to limit elements, at least 1 (the ring itself is rounded up to a power of two).
+        explicit MpmcQueue(size_t limit)
+            : limit_(limit ? limit : 1)
+            , mask_([limit] { size_t n = 2; while (n < limit) n <<= 1; return n - 1; }())
+            , cells_(std::make_unique<Cell[]>(mask_ + 1))
+        {
+            for (size_t i = 0; i <= mask_; i++)
+                cells_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+
+        MpmcQueue(const MpmcQueue& other) = delete;
+        MpmcQueue(MpmcQueue&& other) noexcept = delete;
+        MpmcQueue& operator=(const MpmcQueue& other) = delete;
+        MpmcQueue& operator=(MpmcQueue&& other) noexcept = delete;
+
+        ~MpmcQueue()
+        {
+            while (pop_front()) {}
+        }
+
+        /// True once closed and drained, including pushes that were in flight when close() was called.
+        [[nodiscard]] bool closed() const noexcept
+        {
+            const size_t tail = enqueue_pos_.load(std::memory_order_acquire);
+            return (tail & closed_bit) && dequeue_pos_.load(std::memory_order_acquire) == (tail & ~closed_bit);
+        }
+
+        [[nodiscard]] bool empty() const noexcept
+        {
+            return size() == 0;
+        }
+
+        [[nodiscard]] size_t capacity() const noexcept
+        {
+            return limit_;
+        }
+
+        /// Approximate while other threads push or pop.
+        [[nodiscard]] size_t size() const noexcept
+        {
+            const size_t head = dequeue_pos_.load(std::memory_order_acquire);
+            const size_t tail = enqueue_pos_.load(std::memory_order_acquire) & ~closed_bit;
+            return tail > head ? tail - head : 0;
+        }
+
+        /// Same as size(): there is no weight function, every element weighs 1.
+        [[nodiscard]] size_t weight() const noexcept
+        {
+            return size();
+        }
+
+        /// Counters since construction or reset_statistics(); all zero unless SANDY_QUEUE_STATISTICS is enabled.
+        [[nodiscard]] QueueStatistics statistics() const noexcept
+        {
+            return statistics_.snapshot();
+        }
+
+        void reset_statistics() noexcept
+        {
+            statistics_.reset();
+        }
+
+        /// Pushes value, waiting while the queue is full. Returns false if the queue is closed.
+        template <class... U>
+        bool emplace(U&&... val)
+        {
+            if constexpr (!std::is_nothrow_constructible_v<T, U&&...>)
+            {
+                return emplace(T(std::forward<U>(val)...));
+            }
+            else
+            {
+                Push result = push(std::forward<U>(val)...);
+                if (result == Push::Full)
+                {
+                    auto wait = statistics_.producer_wait();
+                    do
+                    {
+                        can_produce_.wait_until(std::chrono::steady_clock::time_point::max(), [&]
+                        {
+                            return closed_flag() || size() < capacity();
+                        });
+                        result = push(std::forward<U>(val)...);
+                    } while (result == Push::Full);
+                }
+
+                if (result != Push::Done) { statistics_.rejected(); }
+                return result == Push::Done;
+            }
+        }
+
+        /// Pushes value if there is room. Returns false if the queue is full or closed.
+        template <class... U>
+        bool try_emplace(U&&... val)
+        {
+            if constexpr (!std::is_nothrow_constructible_v<T, U&&...>)
+            {
+                return try_emplace(T(std::forward<U>(val)...));
+            }
+            else
+            {
+                if (push(std::forward<U>(val)...) != Push::Done)
+                {
+                    statistics_.rejected();
+                    return false;
+                }
+                return true;
+            }
+        }
+
+        /// Closes queue. Pushes that have not claimed a slot yet fail; consumers still drain what was accepted.
+        void close()
+        {
+            enqueue_pos_.fetch_or(closed_bit, std::memory_order_acq_rel);
+            can_consume_.notify();
+            can_produce_.notify();
+        }
+
+        /// Tries pop value, may returns nullopt if queue is empty or closed.
+        [[nodiscard]] std::optional<T> try_pop()
+        {
+            statistics_.sample([this] { return size(); }, capacity());
+
+            std::optional<T> ret = pop_front();
+            if (!ret) { statistics_.missed(); }
+            return ret;
+        }
+
+        /// Pushes [first, last) one element at a time, waiting while the queue is full.
+        /// Returns the number of elements pushed, less than the range if the queue is closed meanwhile.
+        template <class InputIt>
+        size_t emplace_range(InputIt first, InputIt last)
+        {
+            size_t count = 0;
+            for (; first != last && emplace(*first); ++first)
+                count++;
+            return count;
+        }
+
+        /// Moves up to max queued values to out without waiting. Returns the number of values moved.
+        template <class OutputIt>
+        size_t pop_many(OutputIt out, size_t max = std::numeric_limits<size_t>::max())
+        {
+            statistics_.sample([this] { return size(); }, capacity());
+
+            const size_t n = take(out, max);
+            if (n == 0) { statistics_.missed(); }
+            return n;
+        }
+
+        /// Moves values to out as they arrive until the queue is closed and empty. Returns the number of values moved.
+        /// Other consumers may run concurrently; each value goes to exactly one of them.
+        template <class OutputIt>
+        size_t drain_into(OutputIt out)
+        {
+            size_t count = 0;
+            for (;;)
+            {
+                count += take(out, std::numeric_limits<size_t>::max());
+                if (closed()) { return count; }
+                can_consume_.wait_until(std::chrono::steady_clock::time_point::max(), [&]
+                {
+                    return !empty() || closed();
+                });
+            }
+        }
+
+        /// Destroys values as they arrive until the queue is closed and empty, e.g. to let a blocked producer finish.
+        size_t drain()
+        {
+            return drain_into(Discard{});
+        }
+
+        /// Waits for value.
+        /// may return nullopt if queue is closed.
+        [[nodiscard]] std::optional<T> pop_wait()
+        {
+            return pop_wait_until(std::chrono::steady_clock::time_point::max());
+        }
+
+        /// Waits for value.
+        /// may returns nullopt if queue is closed, or empty till timed out.
+        template <class Rep, class Period>
+        [[nodiscard]] std::optional<T> pop_wait_for(std::chrono::duration<Rep, Period> timeout)
+        {
+            return pop_wait_until(std::chrono::steady_clock::now() + timeout);
+        }
+
+        template <class Clock, class Duration>
+        [[nodiscard]] std::optional<T> pop_wait_until(std::chrono::time_point<Clock, Duration> deadline)
+        {
+            statistics_.sample([this] { return size(); }, capacity());
+            std::optional<T> ret = pop_front();
+            if (!ret && !closed())
+            {
+                auto wait = statistics_.consumer_wait();
+                can_consume_.wait_until(deadline, [&] { return (ret = pop_front()).has_value() || closed(); });
+            }
+
+            if (!ret) { statistics_.missed(); }
+            return ret;
+        }
+    };
+}
@@ -0,0 +1,102 @@
+/// @file
+///	@brief   sandy::parallel_for_tiles
+///	@author  (C) 2023 ttsuki
+
+#pragma once
+
+#include <cstddef>
+#include <type_traits>
+#include <algorithm>
+#include <stdexcept>
+
+#include "./Span.h"
+#include "./TaskScheduler.h"
+
+namespace sandy
+{
+    /// Tile size in elements (and planes for Span3d). 0 selects the default:
+    /// full-width row bands (one plane deep) of about default_tile_bytes, at least one row.
+    struct TileGrain
+    {
+        static constexpr size_t default_tile_bytes = 64 * 1024;
+
+        size_t width{};
+        size_t height{};
+        size_t depth{};
+    };
+
+    namespace parallel_for_detail
+    {
+        // Resolves 0s in grain and returns the number of tiles along each axis.
+        static inline TileGrain resolve(TileGrain& grain, size_t width, size_t height, size_t depth, size_t element_size) noexcept
+        {
+            if (grain.width == 0) grain.width = std::max<size_t>(width, 1);
+            if (grain.height == 0) grain.height = std::max<size_t>(TileGrain::default_tile_bytes / std::max<size_t>(grain.width * element_size, 1), 1);
+            if (grain.depth == 0) grain.depth = 1;
+            auto tiles = [](size_t n, size_t g) { return (n + g - 1) / g; };
+            return TileGrain{tiles(width, grain.width), tiles(height, grain.height), tiles(depth, grain.depth)};
+        }
+
+        template <class F, class... Tiles>
+        static void invoke(F& f, size_t x, size_t y, size_t z, Tiles... tiles)
+        {
+            if constexpr (std::is_invocable_v<F&, Tiles..., size_t, size_t, size_t>) f(tiles..., x, y, z);
+            else if constexpr (std::is_invocable_v<F&, Tiles..., size_t, size_t>) f(tiles..., x, y);
+            else f(tiles...);
+        }
+
+        template <class F, class... Spans>
+        static void for_tiles(TaskScheduler& scheduler, TileGrain grain, F& f, size_t width, size_t height, size_t depth, Spans... spans)
+        {
+            const TileGrain count = resolve(grain, width, height, depth, std::max({sizeof(typename Spans::element_type)...}));
+            if (width == 0 || height == 0 || depth == 0) return;
+
+            // tiles are numbered x-fastest, so the partition depends only on the span sizes and the grain.
+            // one task per tile: a tile is already about default_tile_bytes of work.
+            parallel_for(0, count.width * count.height * count.depth, [&](size_t index)
+            {
+                const size_t x = index % count.width * grain.width;
+                const size_t y = index / count.width % count.height * grain.height;
+                const size_t z = index / count.width / count.height * grain.depth;
+                const size_t w = std::min(grain.width, width - x);
+                const size_t h = std::min(grain.height, height - y);
+                const size_t d = std::min(grain.depth, depth - z);
+                if constexpr (((std::is_same_v<Spans, Span3d<typename Spans::element_type>>) && ...))
+                    invoke(f, x, y, z, spans.slice(x, y, z, w, h, d)...);
+                else
+                    invoke(f, x, y, z, spans.slice(x, y, w, h)...);
+            }, 1, scheduler);
+        }
+    }
+
+    /// Splits span into tiles and calls f(tile) for each on scheduler, where tile is the Span2d slice, and returns when all are done.
+    /// f may also take the tile origin: f(tile, x, y). Calls from inside f nest, the waiting thread runs tiles meanwhile.
+    /// Rethrows the first exception thrown by f; tiles not yet started are skipped.
+    template <class T, class F>
+    void parallel_for_tiles(Span2d<T> span, F&& f, TileGrain grain = {}, TaskScheduler& scheduler = TaskScheduler::shared())
+    {
+        parallel_for_detail::for_tiles(scheduler, grain, f, span.width, span.height, 1, span);
+    }
+
+    /// Lockstep over two equally sized spans: f(src_tile, dst_tile) or f(src_tile, dst_tile, x, y).
+    template <class T, class U, class F>
+    void parallel_for_tiles(Span2d<T> src, Span2d<U> dst, F&& f, TileGrain grain = {}, TaskScheduler& scheduler = TaskScheduler::shared())
+    {
+        if (src.width != dst.width || src.height != dst.height) throw std::invalid_argument("span sizes differ");
+        parallel_for_detail::for_tiles(scheduler, grain, f, src.width, src.height, 1, src, dst);
+    }
+
+    /// Span3d versions: f(tile) or f(tile, x, y, z), tiles are Span3d slices.
+    template <class T, class F>
+    void parallel_for_tiles(Span3d<T> span, F&& f, TileGrain grain = {}, TaskScheduler& scheduler = TaskScheduler::shared())
+    {
+        parallel_for_detail::for_tiles(scheduler, grain, f, span.width, span.height, span.depth, span);
+    }
+
+    template <class T, class U, class F>
+    void parallel_for_tiles(Span3d<T> src, Span3d<U> dst, F&& f, TileGrain grain = {}, TaskScheduler& scheduler = TaskScheduler::shared())
+    {
+        if (src.width != dst.width || src.height != dst.height || src.depth != dst.depth) throw std::invalid_argument("span sizes differ");
+        parallel_for_detail::for_tiles(scheduler, grain, f, src.width, src.height, src.depth, src, dst);
+    }
+}
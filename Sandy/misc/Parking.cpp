@@ -0,0 +1,5 @@
+/// @file
+///	@brief   sandy::Parking, sandy::SpinParking
+///	@author  (C) 2023 ttsuki
+
+#include "./Parking.h"
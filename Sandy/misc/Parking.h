@@ -0,0 +1,74 @@
+/// @file
+///	@brief   sandy::Parking, sandy::SpinParking
+///	@author  (C) 2023 ttsuki
+
+#pragma once
+
+#include <cstddef>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <thread>
+
+namespace sandy
+{
+    /// Wait/notify for lock-free queues: waiters spin briefly, then sleep on a condition_variable.
+    /// notify() only takes the mutex while someone sleeps, so the uncontended path never locks.
+    /// (C++17 has no std::atomic::wait or portable futex; under C++20 the sleep would become atomic::wait on the queue index.)
+    struct Parking final
+    {
+        std::atomic<size_t> sleepers{};
+        std::mutex mutex{};
+        std::condition_variable cv{};
+
+        /// Waits until ready() or the deadline (time_point::max() waits forever). Returns ready().
+        template <class Clock, class Duration, class Ready>
+        bool wait_until(std::chrono::time_point<Clock, Duration> deadline, Ready&& ready)
+        {
+            for (int spin = 0; spin < 64; spin++)
+            {
+                if (ready()) return true;
+                std::this_thread::yield();
+            }
+
+            std::unique_lock lock(mutex);
+            sleepers.fetch_add(1, std::memory_order_seq_cst);
+            std::atomic_thread_fence(std::memory_order_seq_cst); // pairs with notify(): either it sees us, or ready() sees its publish
+            bool result = deadline == std::chrono::time_point<Clock, Duration>::max()
+                              ? (cv.wait(lock, ready), true)
+                              : cv.wait_until(lock, deadline, ready);
+            sleepers.fetch_sub(1, std::memory_order_relaxed);
+            return result;
+        }
+
+        /// Call after publishing the state ready() looks at.
+        void notify()
+        {
+            std::atomic_thread_fence(std::memory_order_seq_cst); // orders the preceding publish before reading sleepers
+            if (sleepers.load(std::memory_order_relaxed) != 0)
+            {
+                std::lock_guard lock(mutex);
+                cv.notify_all();
+            }
+        }
+    };
+
+    /// Parking without sleeping: waiters yield until ready() or the deadline, notify() is free.
+    /// For queues whose both sides are known to be busy, e.g. worker pools.
+    struct SpinParking final
+    {
+        template <class Clock, class Duration, class Ready>
+        bool wait_until(std::chrono::time_point<Clock, Duration> deadline, Ready&& ready)
+        {
+            for (unsigned spin = 0;; spin++)
+            {
+                if (ready()) return true;
+                if ((spin & 63) == 63 && Clock::now() >= deadline) return ready();
+                std::this_thread::yield();
+            }
+        }
+
+        void notify() noexcept { }
+    };
+}
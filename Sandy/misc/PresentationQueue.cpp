@@ -0,0 +1,5 @@
+/// @file
+///	@brief   sandy::PresentationQueue
+///	@author  (C) 2023 ttsuki
+
+#include "./PresentationQueue.h"
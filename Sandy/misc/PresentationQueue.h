@@ -0,0 +1,238 @@
+/// @file
+///	@brief   sandy::PresentationQueue
+///	@author  (C) 2023 ttsuki
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <algorithm>
+#include <iterator>
+#include <mutex>
+#include <condition_variable>
+#include <optional>
+#include <limits>
+#include <functional>
+
+#include "./QueueStatistics.h"
+
+namespace sandy
+{
+    /// Frame counters of a PresentationQueue since construction or reset_statistics(). Always recorded.
+    template <class Time>
+    struct PresentationStatistics
+    {
+        uint64_t presented{}; // frames returned by fetch
+        uint64_t dropped{};   // frames push discarded: past the deadline, not newer than the last presented, or superseded
+        uint64_t late{};      // queued frames fetch skipped because a newer frame was due too
+        Time worst_lateness{}; // largest clock - time of a presented frame
+    };
+
+    /// Bounded queue ordered by presentation time, with one consumer that asks for "the frame for time t".
+    /// fetch(t) returns the newest frame due at t and discards the older ones in one critical section.
+    /// push discards frames the consumer would never present before they take a slot: frames more than deadline
+    /// behind the clock (the t of the last fetch), frames not newer than the last presented one,
+    /// and due frames older than the one being pushed.
+    /// A producer that stays more than deadline behind gets every frame dropped, so choose it above its worst stall.
+    /// The clock is expected to move forward; clear() after a seek.
+    template <class T, class Time = int64_t>
+    class PresentationQueue final
+    {
+    public:
+        /// Presentation time of an element. Must not change while the element is queued.
+        using time_function = std::function<Time(const T&)>;
+        using statistics_type = PresentationStatistics<Time>;
+
+    private:
+        struct Entry
+        {
+            Time time;
+            T value;
+        };
+
+        mutable std::mutex mutex_{};
+        const size_t capacity_{};
+        const time_function time_of_{};
+        const Time deadline_{};
+
+        std::condition_variable can_produce_{};
+        std::deque<Entry> queue_{};
+        std::optional<Time> clock_{};
+        std::optional<Time> presented_{}; // time of the last frame fetch returned
+        bool closed_{};
+        statistics_type presentation_{};
+        QueueStatisticsRecorder statistics_{};
+
+        // first entry later than time. mutex_ must be held.
+        [[nodiscard]] auto upper_bound(Time time)
+        {
+            return std::upper_bound(queue_.begin(), queue_.end(), time, [](Time t, const Entry& e) { return t < e.time; });
+        }
+
+        // true if a frame at time would never be presented. mutex_ must be held.
+        [[nodiscard]] bool stale(Time time) const noexcept
+        {
+            return (presented_ && time <= *presented_) || (clock_ && time < *clock_ && *clock_ - time > deadline_);
+        }
+
+        // drops the entries a due frame at time supersedes. mutex_ must be held.
+        void supersede(Time time)
+        {
+            if (!clock_ || time > *clock_) { return; }
+            const auto end = std::lower_bound(queue_.begin(), queue_.end(), time, [](const Entry& e, Time t) { return e.time < t; });
+            presentation_.dropped += static_cast<uint64_t>(end - queue_.begin());
+            queue_.erase(queue_.begin(), end);
+        }
+
+    public:
+        /// Holds up to capacity frames; frames later than deadline behind the clock are dropped by push.
+        PresentationQueue(size_t capacity, time_function time_of, Time deadline = std::numeric_limits<Time>::max())
+            : capacity_(capacity)
+            , time_of_(std::move(time_of))
+            , deadline_(deadline) { }
+
+        PresentationQueue(const PresentationQueue& other) = delete;
+        PresentationQueue(PresentationQueue&& other) noexcept = delete;
+        PresentationQueue& operator=(const PresentationQueue& other) = delete;
+        PresentationQueue& operator=(PresentationQueue&& other) noexcept = delete;
+        ~PresentationQueue() = default;
+
+        [[nodiscard]] bool closed() const noexcept
+        {
+            std::unique_lock lock(mutex_);
+            return queue_.empty() && closed_;
+        }
+
+        [[nodiscard]] bool empty() const noexcept
+        {
+            std::unique_lock lock(mutex_);
+            return queue_.empty();
+        }
+
+        [[nodiscard]] size_t capacity() const noexcept
+        {
+            return capacity_;
+        }
+
+        [[nodiscard]] size_t size() const noexcept
+        {
+            std::unique_lock lock(mutex_);
+            return queue_.size();
+        }
+
+        /// t of the last fetch, nullopt before the first one.
+        [[nodiscard]] std::optional<Time> clock() const noexcept
+        {
+            std::unique_lock lock(mutex_);
+            return clock_;
+        }
+
+        [[nodiscard]] statistics_type presentation_statistics() const noexcept
+        {
+            std::unique_lock lock(mutex_);
+            return presentation_;
+        }
+
+        /// Counters since construction or reset_statistics(); all zero unless SANDY_QUEUE_STATISTICS is enabled.
+        [[nodiscard]] QueueStatistics statistics() const noexcept
+        {
+            return statistics_.snapshot();
+        }
+
+        void reset_statistics() noexcept
+        {
+            {
+                std::unique_lock lock(mutex_);
+                presentation_ = {};
+            }
+            statistics_.reset();
+        }
+
+        /// Pushes value in presentation order, waiting while the queue is full.
+        /// Returns false if the queue is closed; true also when the frame was dropped as too late.
+        template <class... U>
+        bool emplace(U&&... val)
+        {
+            T value(std::forward<U>(val)...);
+            const Time time = time_of_(value);
+
+            std::unique_lock lock(mutex_);
+            auto ready = [&]
+            {
+                if (closed_ || stale(time)) { return true; }
+                supersede(time);
+                return queue_.size() < capacity_;
+            };
+
+            if (!ready())
+            {
+                auto wait = statistics_.producer_wait();
+                can_produce_.wait(lock, ready);
+            }
+
+            if (closed_)
+            {
+                statistics_.rejected();
+                return false;
+            }
+
+            if (stale(time))
+            {
+                presentation_.dropped++;
+                return true;
+            }
+
+            queue_.insert(upper_bound(time), Entry{time, std::move(value)});
+            statistics_.pushed();
+            return true;
+        }
+
+        /// Closes queue. A producer waiting for room returns false.
+        void close()
+        {
+            std::unique_lock lock(mutex_);
+            closed_ = true;
+            can_produce_.notify_all();
+        }
+
+        /// Discards all frames and forgets the clock, e.g. after a seek.
+        void clear()
+        {
+            std::unique_lock lock(mutex_);
+            queue_.clear();
+            clock_.reset();
+            presented_.reset();
+            can_produce_.notify_all();
+        }
+
+        /// Advances the clock to t and returns the newest frame due at t (time <= t), discarding older ones.
+        /// Returns nullopt if no frame became due since the last fetch.
+        [[nodiscard]] std::optional<T> fetch(Time t)
+        {
+            std::unique_lock lock(mutex_);
+            statistics_.sample([&] { return queue_.size(); }, capacity_);
+            clock_ = t;
+
+            const auto due = upper_bound(t);
+            if (due == queue_.begin())
+            {
+                statistics_.missed();
+                can_produce_.notify_all(); // the new clock may have made a waiting producer's frame stale
+                return std::nullopt;
+            }
+
+            const auto skipped = static_cast<uint64_t>(due - queue_.begin()) - 1;
+            Entry& newest = *std::prev(due);
+            std::optional<T> ret(std::move(newest.value));
+            presentation_.presented++;
+            presentation_.late += skipped;
+            presentation_.worst_lateness = std::max(presentation_.worst_lateness, t - newest.time);
+            presented_ = newest.time;
+            queue_.erase(queue_.begin(), due);
+            statistics_.popped(skipped + 1);
+            can_produce_.notify_all();
+            return ret;
+        }
+    };
+}
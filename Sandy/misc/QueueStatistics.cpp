@@ -0,0 +1,5 @@
+/// @file
+///	@brief   sandy::QueueStatistics
+///	@author  (C) 2023 ttsuki
+
+#include "./QueueStatistics.h"
@@ -0,0 +1,149 @@
+/// @file
+///	@brief   sandy::QueueStatistics
+///	@author  (C) 2023 ttsuki
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <array>
+#include <atomic>
+#include <chrono>
+
+// Queue instrumentation: 1 to record, 0 to compile it out. Defaults to on in debug builds.
+// Must be the same in every translation unit, as it changes the layout of the queues.
+#if !defined(SANDY_QUEUE_STATISTICS)
+#if defined(_DEBUG)
+#define SANDY_QUEUE_STATISTICS 1
+#else
+#define SANDY_QUEUE_STATISTICS 0
+#endif
+#endif
+
+namespace sandy
+{
+    /// Snapshot of a queue's counters since construction or reset_statistics().
+    struct QueueStatistics
+    {
+        /// occupancy[0]: empty, [1] ... [8]: up to 1/8 ... 8/8 of capacity but not full, [9]: full.
+        static constexpr size_t occupancy_buckets = 10;
+
+        bool enabled{};                   // false if compiled out (SANDY_QUEUE_STATISTICS == 0); everything else is zero then
+        uint64_t pushes{};
+        uint64_t pops{};
+        uint64_t rejected_pushes{};       // try_emplace on a full queue, pushes to a closed queue
+        uint64_t empty_pops{};            // pop attempts that returned nothing
+        uint64_t producer_waits{};        // pushes that blocked on a full queue
+        uint64_t consumer_waits{};        // pops that blocked on an empty queue
+        std::chrono::nanoseconds producer_wait_time{};
+        std::chrono::nanoseconds consumer_wait_time{};
+        std::chrono::nanoseconds elapsed{};
+        std::array<uint64_t, occupancy_buckets> occupancy{}; // sampled at each pop attempt
+
+        [[nodiscard]] static constexpr size_t occupancy_bucket(size_t size, size_t capacity) noexcept
+        {
+            return size == 0 ? 0 : size >= capacity ? occupancy_buckets - 1 : 1 + (size - 1) / (capacity / 8 + (capacity % 8 != 0));
+        }
+
+        [[nodiscard]] double push_rate() const noexcept { return elapsed.count() ? pushes * 1e9 / static_cast<double>(elapsed.count()) : 0.0; }
+        [[nodiscard]] double pop_rate() const noexcept { return elapsed.count() ? pops * 1e9 / static_cast<double>(elapsed.count()) : 0.0; }
+    };
+
+#if SANDY_QUEUE_STATISTICS
+    /// Counters a queue updates with relaxed atomics; clock reads happen only on the blocking paths.
+    class QueueStatisticsRecorder final
+    {
+        using clock = std::chrono::steady_clock;
+
+        // producer and consumer counters on separate cache lines, so recording does not add sharing of its own.
+        alignas(64) std::atomic<uint64_t> pushes_{};
+        std::atomic<uint64_t> rejected_pushes_{};
+        std::atomic<uint64_t> producer_waits_{};
+        std::atomic<int64_t> producer_wait_ns_{};
+
+        alignas(64) std::atomic<uint64_t> pops_{};
+        std::atomic<uint64_t> empty_pops_{};
+        std::atomic<uint64_t> consumer_waits_{};
+        std::atomic<int64_t> consumer_wait_ns_{};
+        std::array<std::atomic<uint64_t>, QueueStatistics::occupancy_buckets> occupancy_{};
+
+        std::atomic<int64_t> start_ns_{clock::now().time_since_epoch().count()};
+
+        static void add(std::atomic<uint64_t>& counter, uint64_t n = 1) noexcept { counter.fetch_add(n, std::memory_order_relaxed); }
+
+    public:
+        /// Adds the lifetime of the timer to a wait counter.
+        class Timer final
+        {
+            std::atomic<int64_t>& total_;
+            clock::time_point start_ = clock::now();
+
+        public:
+            Timer(std::atomic<uint64_t>& count, std::atomic<int64_t>& total) noexcept : total_(total) { add(count); }
+            Timer(const Timer& other) = delete;
+            Timer& operator=(const Timer& other) = delete;
+            ~Timer() { total_.fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - start_).count(), std::memory_order_relaxed); }
+        };
+
+        void pushed(size_t n = 1) noexcept { add(pushes_, n); }
+        void popped(size_t n = 1) noexcept { add(pops_, n); }
+        void rejected() noexcept { add(rejected_pushes_); }
+        void missed() noexcept { add(empty_pops_); }
+
+        /// Records the occupancy seen by a pop attempt. size() is only evaluated when statistics are enabled.
+        template <class Size>
+        void sample(Size&& size, size_t capacity) noexcept { add(occupancy_[QueueStatistics::occupancy_bucket(size(), capacity)]); }
+
+        [[nodiscard]] Timer producer_wait() noexcept { return Timer(producer_waits_, producer_wait_ns_); }
+        [[nodiscard]] Timer consumer_wait() noexcept { return Timer(consumer_waits_, consumer_wait_ns_); }
+
+        [[nodiscard]] QueueStatistics snapshot() const noexcept
+        {
+            QueueStatistics s{};
+            s.enabled = true;
+            s.pushes = pushes_.load(std::memory_order_relaxed);
+            s.pops = pops_.load(std::memory_order_relaxed);
+            s.rejected_pushes = rejected_pushes_.load(std::memory_order_relaxed);
+            s.empty_pops = empty_pops_.load(std::memory_order_relaxed);
+            s.producer_waits = producer_waits_.load(std::memory_order_relaxed);
+            s.consumer_waits = consumer_waits_.load(std::memory_order_relaxed);
+            s.producer_wait_time = std::chrono::nanoseconds(producer_wait_ns_.load(std::memory_order_relaxed));
+            s.consumer_wait_time = std::chrono::nanoseconds(consumer_wait_ns_.load(std::memory_order_relaxed));
+            s.elapsed = std::chrono::nanoseconds(clock::now().time_since_epoch().count() - start_ns_.load(std::memory_order_relaxed));
+            for (size_t i = 0; i < occupancy_.size(); i++)
+                s.occupancy[i] = occupancy_[i].load(std::memory_order_relaxed);
+            return s;
+        }
+
+        void reset() noexcept
+        {
+            for (auto* counter : {&pushes_, &pops_, &rejected_pushes_, &empty_pops_, &producer_waits_, &consumer_waits_})
+                counter->store(0, std::memory_order_relaxed);
+            producer_wait_ns_.store(0, std::memory_order_relaxed);
+            consumer_wait_ns_.store(0, std::memory_order_relaxed);
+            for (auto& counter : occupancy_)
+                counter.store(0, std::memory_order_relaxed);
+            start_ns_.store(clock::now().time_since_epoch().count(), std::memory_order_relaxed);
+        }
+    };
+#else
+    class QueueStatisticsRecorder final
+    {
+    public:
+        struct Timer final
+        {
+            ~Timer() { } // keeps `auto wait = ...` from warning as unused
+        };
+
+        void pushed(size_t = 1) noexcept { }
+        void popped(size_t = 1) noexcept { }
+        void rejected() noexcept { }
+        void missed() noexcept { }
+        template <class Size> void sample(Size&&, size_t) noexcept { }
+        [[nodiscard]] Timer producer_wait() noexcept { return {}; }
+        [[nodiscard]] Timer consumer_wait() noexcept { return {}; }
+        [[nodiscard]] QueueStatistics snapshot() const noexcept { return {}; }
+        void reset() noexcept { }
+    };
+#endif
+}
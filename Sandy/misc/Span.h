@@ -44,6 +44,12 @@ namespace sandy
         {
             return Span1d<U>{pointer, width * sizeof(T) / sizeof(U)};
         }
+
+        template <class U = T, std::enable_if_t<!std::is_const_v<U>, int> = 0>
+        [[nodiscard]] constexpr operator Span1d<const U>() const noexcept
+        {
+            return Span1d<const U>{pointer, width};
+        }
     };
 
     template <class T>
@@ -80,6 +86,12 @@ namespace sandy
         {
             return Span2d<U>{pointer, width * sizeof(T) / sizeof(U), height, width_pitch};
         }
+
+        template <class U = T, std::enable_if_t<!std::is_const_v<U>, int> = 0>
+        [[nodiscard]] constexpr operator Span2d<const U>() const noexcept
+        {
+            return Span2d<const U>{pointer, width, height, width_pitch};
+        }
     };
 
     template <class T>
@@ -120,6 +132,12 @@ namespace sandy
         {
             return Span3d<U>{pointer, width * sizeof(T) / sizeof(U), height, depth, width_pitch, height_pitch};
         }
+
+        template <class U = T, std::enable_if_t<!std::is_const_v<U>, int> = 0>
+        [[nodiscard]] constexpr operator Span3d<const U>() const noexcept
+        {
+            return Span3d<const U>{pointer, width, height, depth, width_pitch, height_pitch};
+        }
     };
 
     using ByteSpan1d = Span1d<std::byte>;
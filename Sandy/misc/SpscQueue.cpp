@@ -0,0 +1,5 @@
+/// @file
+///	@brief   sandy::SpscQueue
+///	@author  (C) 2023 ttsuki
+
+#include "./SpscQueue.h"
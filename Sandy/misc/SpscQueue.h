@@ -0,0 +1,407 @@
+/// @file
+///	@brief   sandy::SpscQueue
+///	@author  (C) 2023 ttsuki
+
+#pragma once
+
+#include <cstddef>
+#include <atomic>
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <chrono>
+#include <new>
+#include <utility>
+#include <functional>
+
+#include "./Parking.h"
+#include "./QueueStatistics.h"
+
+namespace sandy
+{
+    /// Bounded lock-free single-producer/single-consumer ring with the ConcurrentQueue surface.
+    /// emplace/try_emplace from one thread and try_pop/pop_wait/pop_wait_for from one (other) thread at a time.
+    /// Push and pop are one release store each and never lock; the blocking calls spin briefly, then park on
+    /// a mutex/condition_variable that the other side only touches while someone is parked.
+    template <class T>
+    class SpscQueue final
+    {
+    public:
+        /// Weight of an element in capacity units, e.g. its size in bytes. Must not change while the element is queued.
+        using weight_function = std::function<size_t(const T&)>;
+
+    private:
+        static constexpr size_t cache_line = 64;
+
+        struct alignas(T) Slot
+        {
+            std::byte storage[sizeof(T)];
+        };
+
+        const size_t capacity_{};     // in weight units
+        const size_t limit_{};        // in elements
+        const weight_function weight_of_{};
+        const size_t mask_{};
+        std::unique_ptr<Slot[]> slots_{};
+
+        // producer line
+        alignas(cache_line) std::atomic<size_t> tail_{};
+        std::atomic<size_t> pushed_weight_{}; // with weight_of_ only
+        size_t cached_head_{};
+
+        // consumer line
+        alignas(cache_line) std::atomic<size_t> head_{};
+        std::atomic<size_t> popped_weight_{}; // with weight_of_ only
+        size_t cached_tail_{};
+
+        alignas(cache_line) std::atomic<bool> closed_{};
+        Parking can_produce_{};
+        Parking can_consume_{};
+        alignas(cache_line) QueueStatisticsRecorder statistics_{};
+
+        T* slot(size_t index) const noexcept { return std::launder(reinterpret_cast<T*>(slots_[index & mask_].storage)); }
+
+        // true if an element of the weight does not fit. One heavier than the whole capacity still goes into an empty queue.
+        [[nodiscard]] bool full(size_t weight = 1) noexcept
+        {
+            const size_t tail = tail_.load(std::memory_order_relaxed);
+            if (tail - cached_head_ >= limit_)
+            {
+                cached_head_ = head_.load(std::memory_order_acquire);
+                if (tail - cached_head_ >= limit_) return true;
+            }
+
+            if (!weight_of_) return false;
+            const size_t queued = pushed_weight_.load(std::memory_order_relaxed) - popped_weight_.load(std::memory_order_acquire);
+            return queued != 0 && queued + weight > capacity_;
+        }
+
+        [[nodiscard]] bool readable() noexcept
+        {
+            const size_t head = head_.load(std::memory_order_relaxed);
+            if (head != cached_tail_) return true;
+            cached_tail_ = tail_.load(std::memory_order_acquire);
+            return head != cached_tail_;
+        }
+
+        template <class... U>
+        void push(size_t weight, U&&... val)
+        {
+            const size_t tail = tail_.load(std::memory_order_relaxed);
+            ::new(static_cast<void*>(slots_[tail & mask_].storage)) T(std::forward<U>(val)...);
+            if (weight_of_) pushed_weight_.store(pushed_weight_.load(std::memory_order_relaxed) + weight, std::memory_order_release);
+            tail_.store(tail + 1, std::memory_order_release);
+            statistics_.pushed();
+            can_consume_.notify();
+        }
+
+        std::optional<T> pop_front()
+        {
+            if (!readable()) { return std::nullopt; }
+
+            const size_t head = head_.load(std::memory_order_relaxed);
+            T* p = slot(head);
+            const size_t weight = weight_of_ ? weight_of_(*p) : 0;
+            std::optional<T> ret(std::move(*p));
+            p->~T();
+            if (weight_of_) popped_weight_.store(popped_weight_.load(std::memory_order_relaxed) + weight, std::memory_order_release);
+            head_.store(head + 1, std::memory_order_release);
+            statistics_.popped();
+            can_produce_.notify();
+            return ret;
+        }
+
+        template <class... U>
+        bool emplace_as(size_t weight, U&&... val)
+        {
+            if (closed_.load(std::memory_order_acquire))
+            {
+                statistics_.rejected();
+                return false;
+            }
+
+            if (full(weight))
+            {
+                auto wait = statistics_.producer_wait();
+                can_produce_.wait_until(std::chrono::steady_clock::time_point::max(), [&]
+                {
+                    return !full(weight) || closed_.load(std::memory_order_acquire);
+                });
+            }
+
+            if (closed_.load(std::memory_order_acquire))
+            {
+                statistics_.rejected();
+                return false;
+            }
+
+            push(weight, std::forward<U>(val)...);
+            return true;
+        }
+
+        template <class... U>
+        bool try_emplace_as(size_t weight, U&&... val)
+        {
+            if (closed_.load(std::memory_order_acquire) || full(weight))
+            {
+                statistics_.rejected();
+                return false;
+            }
+            push(weight, std::forward<U>(val)...);
+            return true;
+        }
+
+        // output iterator dropping what is assigned to it.
+        struct Discard
+        {
+            Discard& operator *() noexcept { return *this; }
+            Discard& operator ++() noexcept { return *this; }
+            template <class V> Discard& operator =(V&&) noexcept { return *this; }
+        };
+
+        // moves up to max readable values to out, publishing head once.
+        template <class OutputIt>
+        size_t take(OutputIt& out, size_t max)
+        {
+            const size_t head = head_.load(std::memory_order_relaxed);
+            cached_tail_ = tail_.load(std::memory_order_acquire);
+            const size_t n = std::min(max, cached_tail_ - head);
+            if (n == 0) { return 0; }
+
+            size_t weight = 0;
+            for (size_t i = 0; i < n; i++)
+            {
+                T* p = slot(head + i);
+                if (weight_of_) weight += weight_of_(*p);
+                *out = std::move(*p);
+                ++out;
+                p->~T();
+            }
+            if (weight_of_) popped_weight_.store(popped_weight_.load(std::memory_order_relaxed) + weight, std::memory_order_release);
+            head_.store(head + n, std::memory_order_release);
+            statistics_.popped(n);
+            can_produce_.notify();
+            return n;
+        }
+
+    public:
+        /// Holds up to limit elements (the ring itself is rounded up to a power of two).
+        explicit SpscQueue(size_t limit)
+            : SpscQueue(limit, {}, limit) { }
+
+        /// Holds up to max_elements elements while their total weight(element) stays within capacity.
+        SpscQueue(size_t capacity, weight_function weight, size_t max_elements)
+            : capacity_(weight ? capacity : max_elements)
+            , limit_(max_elements)
+            , weight_of_(std::move(weight))
+            , mask_([max_elements] { size_t n = 1; while (n < max_elements) n <<= 1; return n - 1; }())
+            , slots_(std::make_unique<Slot[]>(mask_ + 1)) { }
+
+        SpscQueue(const SpscQueue& other) = delete;
+        SpscQueue(SpscQueue&& other) noexcept = delete;
+        SpscQueue& operator=(const SpscQueue& other) = delete;
+        SpscQueue& operator=(SpscQueue&& other) noexcept = delete;
+
+        ~SpscQueue()
+        {
+            for (size_t i = head_.load(), end = tail_.load(); i != end; i++)
+                slot(i)->~T();
+        }
+
+        /// True once closed and drained.
+        [[nodiscard]] bool closed() const noexcept
+        {
+            return closed_.load(std::memory_order_acquire) && empty();
+        }
+
+        [[nodiscard]] bool empty() const noexcept
+        {
+            return size() == 0;
+        }
+
+        [[nodiscard]] size_t capacity() const noexcept
+        {
+            return capacity_;
+        }
+
+        [[nodiscard]] size_t size() const noexcept
+        {
+            const size_t head = head_.load(std::memory_order_acquire);
+            return tail_.load(std::memory_order_acquire) - head;
+        }
+
+        /// Total weight of the queued elements; size() without a weight function.
+        /// Exact from the producer or consumer thread, approximate from a third one.
+        [[nodiscard]] size_t weight() const noexcept
+        {
+            if (!weight_of_) return size();
+            const size_t popped = popped_weight_.load(std::memory_order_acquire);
+            return pushed_weight_.load(std::memory_order_acquire) - popped;
+        }
+
+        /// Counters since construction or reset_statistics(); all zero unless SANDY_QUEUE_STATISTICS is enabled.
+        [[nodiscard]] QueueStatistics statistics() const noexcept
+        {
+            return statistics_.snapshot();
+        }
+
+        void reset_statistics() noexcept
+        {
+            statistics_.reset();
+        }
+
+        /// Pushes value, waiting while the queue is full. Returns false if the queue is closed.
+        template <class... U>
+        bool emplace(U&&... val)
+        {
+            if (weight_of_)
+            {
+                T value(std::forward<U>(val)...); // weighing needs the element
+                const size_t weight = weight_of_(value);
+                return emplace_as(weight, std::move(value));
+            }
+            return emplace_as(1, std::forward<U>(val)...);
+        }
+
+        /// Pushes value if there is room. Returns false if the queue is full or closed.
+        template <class... U>
+        bool try_emplace(U&&... val)
+        {
+            if (weight_of_)
+            {
+                T value(std::forward<U>(val)...);
+                const size_t weight = weight_of_(value);
+                return try_emplace_as(weight, std::move(value));
+            }
+            return try_emplace_as(1, std::forward<U>(val)...);
+        }
+
+        /// Closes queue.
+        void close()
+        {
+            closed_.store(true, std::memory_order_release);
+            can_consume_.notify();
+            can_produce_.notify();
+        }
+
+        /// Tries pop value, may returns nullopt if queue is empty or closed.
+        [[nodiscard]] std::optional<T> try_pop()
+        {
+            statistics_.sample([this] { return weight(); }, capacity_);
+
+            std::optional<T> ret = pop_front();
+            if (!ret) { statistics_.missed(); }
+            return ret;
+        }
+
+        /// Pushes [first, last), as many at a time as there is room for, waiting while the queue is full.
+        /// Returns the number of elements pushed, less than the range if the queue is closed meanwhile.
+        template <class InputIt>
+        size_t emplace_range(InputIt first, InputIt last)
+        {
+            size_t count = 0;
+            if (weight_of_)
+            {
+                for (; first != last && emplace(*first); ++first)
+                    count++;
+                return count;
+            }
+
+            while (first != last)
+            {
+                if (closed_.load(std::memory_order_acquire))
+                {
+                    statistics_.rejected();
+                    break;
+                }
+
+                if (full())
+                {
+                    auto wait = statistics_.producer_wait();
+                    can_produce_.wait_until(std::chrono::steady_clock::time_point::max(), [&]
+                    {
+                        return !full() || closed_.load(std::memory_order_acquire);
+                    });
+                    continue;
+                }
+
+                const size_t tail = tail_.load(std::memory_order_relaxed);
+                cached_head_ = head_.load(std::memory_order_acquire);
+                size_t n = 0;
+                for (; first != last && tail + n - cached_head_ < limit_; ++first, ++n)
+                    ::new(static_cast<void*>(slots_[(tail + n) & mask_].storage)) T(*first);
+
+                tail_.store(tail + n, std::memory_order_release);
+                statistics_.pushed(n);
+                can_consume_.notify();
+                count += n;
+            }
+            return count;
+        }
+
+        /// Moves up to max queued values to out without waiting. Returns the number of values moved.
+        template <class OutputIt>
+        size_t pop_many(OutputIt out, size_t max = std::numeric_limits<size_t>::max())
+        {
+            statistics_.sample([this] { return weight(); }, capacity_);
+
+            const size_t n = take(out, max);
+            if (n == 0) { statistics_.missed(); }
+            return n;
+        }
+
+        /// Moves values to out as they arrive until the queue is closed and empty. Returns the number of values moved.
+        template <class OutputIt>
+        size_t drain_into(OutputIt out)
+        {
+            size_t count = 0;
+            for (;;)
+            {
+                count += take(out, std::numeric_limits<size_t>::max());
+                if (closed()) { return count; }
+                can_consume_.wait_until(std::chrono::steady_clock::time_point::max(), [&]
+                {
+                    return readable() || closed_.load(std::memory_order_acquire);
+                });
+            }
+        }
+
+        /// Destroys values as they arrive until the queue is closed and empty, e.g. to let a blocked producer finish.
+        size_t drain()
+        {
+            return drain_into(Discard{});
+        }
+
+        /// Waits for value.
+        /// may return nullopt if queue is closed.
+        [[nodiscard]] std::optional<T> pop_wait()
+        {
+            return pop_wait_until(std::chrono::steady_clock::time_point::max());
+        }
+
+        /// Waits for value.
+        /// may returns nullopt if queue is closed, or empty till timed out.
+        template <class Rep, class Period>
+        [[nodiscard]] std::optional<T> pop_wait_for(std::chrono::duration<Rep, Period> timeout)
+        {
+            return pop_wait_until(std::chrono::steady_clock::now() + timeout);
+        }
+
+        template <class Clock, class Duration>
+        [[nodiscard]] std::optional<T> pop_wait_until(std::chrono::time_point<Clock, Duration> deadline)
+        {
+            statistics_.sample([this] { return weight(); }, capacity_);
+            if (auto ret = pop_front()) { return ret; }
+
+            {
+                auto wait = statistics_.consumer_wait();
+                can_consume_.wait_until(deadline, [&] { return readable() || closed_.load(std::memory_order_acquire); });
+            }
+
+            std::optional<T> ret = pop_front();
+            if (!ret) { statistics_.missed(); }
+            return ret;
+        }
+    };
+}
@@ -0,0 +1,228 @@
+/// @file
+///	@brief   sandy::TaskScheduler, sandy::TaskGroup, sandy::parallel_for
+///	@author  (C) 2023 ttsuki
+
+#include "./TaskScheduler.h"
+
+namespace sandy
+{
+    // scheduler the calling thread works for, and its worker index; nullptr on other threads.
+    static thread_local TaskScheduler* current_scheduler = nullptr;
+    static thread_local size_t current_worker = 0;
+
+    // worker the calling thread tried to steal from last, so thieves spread over the victims.
+    static thread_local size_t steal_cursor = 0;
+
+    static std::mutex shared_mutex{};
+    static size_t shared_workers = std::max(std::thread::hardware_concurrency(), 1u) - 1;
+    static bool shared_created = false;
+
+    TaskScheduler::TaskScheduler(size_t workers)
+    {
+        workers_.reserve(workers);
+        for (size_t i = 0; i < workers; i++)
+            workers_.push_back(std::make_unique<Worker>());
+
+        threads_.reserve(workers);
+        for (size_t i = 0; i < workers; i++)
+            threads_.emplace_back([this, i] { worker(i); });
+    }
+
+    TaskScheduler::~TaskScheduler()
+    {
+        stopping_.store(true, std::memory_order_release);
+        wake_.notify();
+        for (auto& thread : threads_)
+            thread.join();
+
+        // without workers, nobody else runs what was submitted.
+        while (Task* task = find_task())
+            execute(task);
+    }
+
+    void TaskScheduler::worker(size_t index) noexcept
+    {
+        current_scheduler = this;
+        current_worker = index;
+        steal_cursor = index + 1;
+
+        while (true)
+        {
+            if (Task* task = find_task())
+            {
+                execute(task);
+                continue;
+            }
+
+            if (stopping_.load(std::memory_order_acquire))
+            {
+                if (!has_work()) return;
+                continue;
+            }
+
+            wake_.wait_until(std::chrono::steady_clock::time_point::max(), [this]
+            {
+                return stopping_.load(std::memory_order_acquire) || has_work();
+            });
+        }
+    }
+
+    void TaskScheduler::enqueue(Task* task)
+    {
+        if (current_scheduler == this)
+        {
+            workers_[current_worker]->tasks.push(task);
+        }
+        else
+        {
+            std::lock_guard lock(injected_mutex_);
+            injected_.push_back(task);
+            injected_count_.fetch_add(1, std::memory_order_release);
+        }
+        wake_.notify();
+    }
+
+    TaskScheduler::Task* TaskScheduler::find_task() noexcept
+    {
+        const bool own = current_scheduler == this;
+        if (own)
+        {
+            if (auto task = workers_[current_worker]->tasks.pop())
+                return *task;
+        }
+
+        if (injected_count_.load(std::memory_order_acquire) != 0)
+        {
+            // workers take the oldest, while a waiting thread takes the newest, likely the one it just spawned,
+            // as a worker does from its own deque: oldest-first would nest unrelated tasks on its stack.
+            std::lock_guard lock(injected_mutex_);
+            if (!injected_.empty())
+            {
+                Task* task;
+                if (own)
+                {
+                    task = injected_.front();
+                    injected_.pop_front();
+                }
+                else
+                {
+                    task = injected_.back();
+                    injected_.pop_back();
+                }
+                injected_count_.fetch_sub(1, std::memory_order_relaxed);
+                return task;
+            }
+        }
+
+        const size_t count = workers_.size();
+        for (size_t i = 0; i < count; i++)
+        {
+            const size_t victim = (steal_cursor + i) % count;
+            if (own && victim == current_worker) continue;
+            if (auto task = workers_[victim]->tasks.steal())
+            {
+                steal_cursor = victim;
+                return *task;
+            }
+        }
+        return nullptr;
+    }
+
+    void TaskScheduler::execute(Task* task) noexcept
+    {
+        std::unique_ptr<Task> owned(task);
+        TaskGroup* group = task->group;
+        if (!group)
+        {
+            task->run(); // throwing from a detached task terminates
+            return;
+        }
+
+        if (!group->failed_.load(std::memory_order_relaxed))
+        {
+            try
+            {
+                task->run();
+            }
+            catch (...)
+            {
+                group->fail(std::current_exception());
+            }
+        }
+
+        // the task's captures may point into the waiter's frame, and the group is gone once pending_ reaches 0.
+        owned.reset();
+        if (group->pending_.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            wake_.notify();
+    }
+
+    bool TaskScheduler::has_work() const noexcept
+    {
+        if (injected_count_.load(std::memory_order_acquire) != 0) return true;
+        for (auto& worker : workers_)
+            if (!worker->tasks.empty()) return true;
+        return false;
+    }
+
+    bool TaskScheduler::try_run_one()
+    {
+        if (Task* task = find_task())
+        {
+            execute(task);
+            return true;
+        }
+        return false;
+    }
+
+    TaskScheduler& TaskScheduler::shared()
+    {
+        static TaskScheduler& scheduler = []() -> TaskScheduler&
+        {
+            std::lock_guard lock(shared_mutex);
+            shared_created = true;
+            static TaskScheduler instance{shared_workers};
+            return instance;
+        }();
+        return scheduler;
+    }
+
+    bool TaskScheduler::configure_shared(size_t workers)
+    {
+        std::lock_guard lock(shared_mutex);
+        if (shared_created) return false;
+        shared_workers = workers;
+        return true;
+    }
+
+    TaskGroup::~TaskGroup()
+    {
+        try
+        {
+            wait();
+        }
+        catch (...)
+        {
+            // dropped, see declaration.
+        }
+    }
+
+    void TaskGroup::fail(std::exception_ptr error) noexcept
+    {
+        failed_.store(true, std::memory_order_relaxed);
+        std::lock_guard lock(error_mutex_);
+        if (!error_) error_ = std::move(error);
+    }
+
+    void TaskGroup::wait()
+    {
+        scheduler_.run_until([this] { return pending_.load(std::memory_order_acquire) == 0; });
+
+        failed_.store(false, std::memory_order_relaxed);
+        std::exception_ptr error{};
+        {
+            std::lock_guard lock(error_mutex_);
+            error = std::exchange(error_, nullptr);
+        }
+        if (error) std::rethrow_exception(error);
+    }
+}
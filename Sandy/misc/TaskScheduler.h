@@ -0,0 +1,208 @@
+/// @file
+///	@brief   sandy::TaskScheduler, sandy::TaskGroup, sandy::parallel_for
+///	@author  (C) 2023 ttsuki
+
+#pragma once
+
+#include <cstddef>
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <exception>
+#include <type_traits>
+#include <algorithm>
+#include <utility>
+#include <chrono>
+
+#include "./Parking.h"
+#include "./WorkStealingDeque.h"
+
+namespace sandy
+{
+    class TaskGroup;
+
+    /// Work-stealing scheduler for short CPU-bound tasks (conversion, rasterization, geometry building).
+    /// Each worker pushes the tasks it spawns onto its own WorkStealingDeque and runs them newest first;
+    /// idle workers steal the oldest task of another worker. Tasks submitted from other threads go through a shared queue.
+    /// Tasks must not block on I/O or on other threads except through TaskGroup::wait, which runs tasks while it waits.
+    class TaskScheduler final
+    {
+        friend class TaskGroup;
+
+        struct Task
+        {
+            TaskGroup* group{};
+            virtual ~Task() = default;
+            virtual void run() = 0;
+        };
+
+        template <class F>
+        struct TaskOf final : Task
+        {
+            F f;
+            template <class U> explicit TaskOf(U&& f) : f(std::forward<U>(f)) { }
+            void run() override { f(); }
+        };
+
+        struct Worker
+        {
+            WorkStealingDeque<Task*> tasks{};
+        };
+
+        std::vector<std::unique_ptr<Worker>> workers_{};
+        std::mutex injected_mutex_{};
+        std::deque<Task*> injected_{}; // tasks from threads that are not workers of this scheduler
+        std::atomic<size_t> injected_count_{};
+        std::atomic<bool> stopping_{};
+        Parking wake_{}; // idle workers and TaskGroup::wait
+        std::vector<std::thread> threads_{};
+
+        void worker(size_t index) noexcept;
+        void enqueue(Task* task);
+        Task* find_task() noexcept;
+        void execute(Task* task) noexcept;
+        [[nodiscard]] bool has_work() const noexcept;
+
+        template <class F>
+        void spawn(TaskGroup* group, F&& f)
+        {
+            auto task = std::make_unique<TaskOf<std::decay_t<F>>>(std::forward<F>(f));
+            task->group = group;
+            enqueue(task.get());
+            task.release();
+        }
+
+    public:
+        /// workers: threads besides the callers that wait on it. Defaults to hardware_concurrency() - 1.
+        explicit TaskScheduler(size_t workers = std::max(std::thread::hardware_concurrency(), 1u) - 1);
+        TaskScheduler(const TaskScheduler& other) = delete;
+        TaskScheduler(TaskScheduler&& other) noexcept = delete;
+        TaskScheduler& operator=(const TaskScheduler& other) = delete;
+        TaskScheduler& operator=(TaskScheduler&& other) noexcept = delete;
+
+        /// Runs the tasks still queued, then stops the workers.
+        ~TaskScheduler();
+
+        /// Number of threads that run tasks while someone waits, including the waiting one.
+        [[nodiscard]] size_t concurrency() const noexcept { return workers_.size() + 1; }
+
+        /// Queues f() without a group to wait on. f must not throw: an exception terminates the process, as from a std::thread.
+        template <class F>
+        void submit(F&& f)
+        {
+            spawn(nullptr, std::forward<F>(f));
+        }
+
+        /// Runs one queued task on the calling thread, e.g. to lend a main loop's idle time. Returns false if none was found.
+        bool try_run_one();
+
+        /// Runs queued tasks on the calling thread until ready() holds, sleeping while there are none.
+        /// Whatever makes ready() true must call notify() afterwards.
+        template <class Ready>
+        void run_until(Ready&& ready)
+        {
+            while (!ready())
+            {
+                if (Task* task = find_task())
+                {
+                    execute(task);
+                    continue;
+                }
+
+                wake_.wait_until(std::chrono::steady_clock::time_point::max(), [&] { return ready() || has_work(); });
+            }
+        }
+
+        /// Wakes the threads in run_until and TaskGroup::wait to check their condition again.
+        void notify() { wake_.notify(); }
+
+        /// Process-wide scheduler, created on first use with the worker count given to configure_shared(), or the default.
+        static TaskScheduler& shared();
+
+        /// Sets the worker count of shared(). Returns false if shared() already exists.
+        static bool configure_shared(size_t workers);
+    };
+
+    /// Set of tasks to wait for as a whole. wait() runs queued tasks on the calling thread until the group is done,
+    /// so waiting from the main thread, or from a task, adds a thread instead of blocking one.
+    class TaskGroup final
+    {
+        friend class TaskScheduler;
+
+        TaskScheduler& scheduler_;
+        std::atomic<size_t> pending_{};
+        std::atomic<bool> failed_{};
+        std::mutex error_mutex_{};
+        std::exception_ptr error_{};
+
+        void fail(std::exception_ptr error) noexcept;
+
+    public:
+        explicit TaskGroup(TaskScheduler& scheduler = TaskScheduler::shared()) : scheduler_(scheduler) { }
+        TaskGroup(const TaskGroup& other) = delete;
+        TaskGroup(TaskGroup&& other) noexcept = delete;
+        TaskGroup& operator=(const TaskGroup& other) = delete;
+        TaskGroup& operator=(TaskGroup&& other) noexcept = delete;
+
+        /// Waits for the tasks still running; an exception not collected by wait() is dropped.
+        ~TaskGroup();
+
+        /// Queues f(). Once a task of the group has thrown, the tasks not started yet are skipped.
+        template <class F>
+        void run(F&& f)
+        {
+            pending_.fetch_add(1, std::memory_order_relaxed);
+            try
+            {
+                scheduler_.spawn(this, std::forward<F>(f));
+            }
+            catch (...)
+            {
+                pending_.fetch_sub(1, std::memory_order_relaxed);
+                throw;
+            }
+        }
+
+        /// Skips the tasks of the group not started yet.
+        void cancel() noexcept { failed_.store(true, std::memory_order_relaxed); }
+
+        /// Runs tasks until every task of the group has finished. Rethrows the first exception thrown by one of them.
+        void wait();
+    };
+
+    /// Calls f(index) for index in [first, last) on scheduler and returns when all are done.
+    /// The range is split in halves down to grain indices per task, so idle workers steal large pieces first.
+    /// grain 0 picks about 8 pieces per thread. Rethrows the first exception thrown by f; pieces not yet started are skipped.
+    template <class F>
+    void parallel_for(size_t first, size_t last, F&& f, size_t grain = 0, TaskScheduler& scheduler = TaskScheduler::shared())
+    {
+        if (first >= last) return;
+        if (grain == 0) grain = std::max<size_t>((last - first) / (scheduler.concurrency() * 8), 1);
+
+        TaskGroup group(scheduler);
+        auto split = [&](auto& self, size_t begin, size_t end) -> void
+        {
+            while (end - begin > grain)
+            {
+                const size_t middle = begin + (end - begin) / 2;
+                group.run([&self, middle, end] { self(self, middle, end); });
+                end = middle;
+            }
+            for (size_t i = begin; i < end; i++) f(i);
+        };
+
+        try
+        {
+            split(split, first, last);
+        }
+        catch (...)
+        {
+            group.cancel(); // ~TaskGroup waits for the pieces already running
+            throw;
+        }
+        group.wait();
+    }
+}
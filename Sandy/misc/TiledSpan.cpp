@@ -0,0 +1,145 @@
+/// @file
+///	@brief   sandy::TiledSpan2d
+///	@author  (C) 2023 ttsuki
+
+#include "./TiledSpan.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "./ark/xmm.h"
+
+namespace sandy
+{
+    // Copies one whole tile between linear rows (line, pitch in bytes) and its contiguous storage.
+    template <bool ToTiled, class T, size_t Tile, TileOrder Order>
+    static void copy_tile(std::conditional_t<ToTiled, const std::byte*, std::byte*> line, size_t pitch, std::conditional_t<ToTiled, T*, const T*> tile) noexcept
+    {
+        using Span = TiledSpan2d<T, Tile, Order>;
+        auto at = [line, pitch](size_t x, size_t y) { return reinterpret_cast<std::conditional_t<ToTiled, const T*, T*>>(line + y * pitch) + x; };
+        auto move = [](auto* dst, const auto* src, size_t count) { std::memcpy(dst, src, count * sizeof(T)); };
+
+        if constexpr (Order == TileOrder::RowMajor)
+        {
+            for (size_t y = 0; y < Tile; y++)
+                if constexpr (ToTiled) move(tile + y * Tile, at(0, y), Tile);
+                else move(at(0, y), tile + y * Tile, Tile);
+        }
+#if defined(__AVX2__)
+        else if constexpr (sizeof(T) == 4 && Tile >= 8)
+        {
+            // 8 elements of rows y, y + 1 are four 2x2 blocks at index(x, y) and index(x + 4, y) = index(x, y) + 16:
+            // unpack64 pairs up the block rows, permute128 orders the blocks.
+            using namespace arkxmm;
+            for (size_t y = 0; y < Tile; y += 2)
+            {
+                for (size_t x = 0; x < Tile; x += 8)
+                {
+                    auto* block = tile + Span::index(x, y);
+                    if constexpr (ToTiled)
+                    {
+                        const vu32x8 r0 = load_u<vu32x8>(at(x, y));
+                        const vu32x8 r1 = load_u<vu32x8>(at(x, y + 1));
+                        const vu32x8 lo = unpack64_lo(r0, r1);
+                        const vu32x8 hi = unpack64_hi(r0, r1);
+                        store_u<vu32x8>(block, permute128<0, 2>(lo, hi));
+                        store_u<vu32x8>(block + 16, permute128<1, 3>(lo, hi));
+                    }
+                    else
+                    {
+                        const vu32x8 a = load_u<vu32x8>(block);
+                        const vu32x8 b = load_u<vu32x8>(block + 16);
+                        const vu32x8 lo = permute128<0, 2>(a, b);
+                        const vu32x8 hi = permute128<1, 3>(a, b);
+                        store_u<vu32x8>(at(x, y), unpack64_lo(lo, hi));
+                        store_u<vu32x8>(at(x, y + 1), unpack64_hi(lo, hi));
+                    }
+                }
+            }
+        }
+#endif
+        else
+        {
+            // 2x2 blocks: two elements of each row are adjacent in both layouts.
+            for (size_t y = 0; y < Tile; y += 2)
+            {
+                for (size_t x = 0; x < Tile; x += 2)
+                {
+                    auto* block = tile + Span::index(x, y);
+                    if constexpr (ToTiled)
+                    {
+                        move(block, at(x, y), 2);
+                        move(block + 2, at(x, y + 1), 2);
+                    }
+                    else
+                    {
+                        move(at(x, y), block, 2);
+                        move(at(x, y + 1), block + 2, 2);
+                    }
+                }
+            }
+        }
+    }
+
+    template <bool ToTiled, class T, size_t Tile, TileOrder Order, class Linear>
+    static void convert(Linear linear, TiledSpan2d<std::conditional_t<ToTiled, T, const T>, Tile, Order> tiled) noexcept
+    {
+        const size_t width = std::min(linear.width, tiled.width);
+        const size_t height = std::min(linear.height, tiled.height);
+        auto line = [&linear](size_t x, size_t y) { return static_cast<std::conditional_t<ToTiled, const std::byte*, std::byte*>>(linear.row(y).slice(x, 0).pointer); };
+
+        // tile by tile, in storage coordinates.
+        for (size_t ty = tiled.y0 / Tile * Tile; ty < tiled.y0 + height; ty += Tile)
+        {
+            for (size_t tx = tiled.x0 / Tile * Tile; tx < tiled.x0 + width; tx += Tile)
+            {
+                auto* tile = tiled.tile(tx, ty);
+                const size_t sx0 = std::max(tx, tiled.x0), sx1 = std::min(tx + Tile, tiled.x0 + width);
+                const size_t sy0 = std::max(ty, tiled.y0), sy1 = std::min(ty + Tile, tiled.y0 + height);
+
+                if (sx1 - sx0 == Tile && sy1 - sy0 == Tile)
+                {
+                    copy_tile<ToTiled, T, Tile, Order>(line(tx - tiled.x0, ty - tiled.y0), linear.width_pitch, tile);
+                    continue;
+                }
+
+                // partial tile
+                for (size_t sy = sy0; sy < sy1; sy++)
+                {
+                    for (size_t sx = sx0; sx < sx1; sx++)
+                    {
+                        auto* element = reinterpret_cast<std::conditional_t<ToTiled, const T*, T*>>(line(sx - tiled.x0, sy - tiled.y0));
+                        if constexpr (ToTiled) tile[tiled.index(sx % Tile, sy % Tile)] = *element;
+                        else *element = tile[tiled.index(sx % Tile, sy % Tile)];
+                    }
+                }
+            }
+        }
+    }
+
+    template <class Tiled>
+    void to_tiled(Span2d<const typename Tiled::element_type> src, Tiled dst) noexcept
+    {
+        convert<true, typename Tiled::element_type, Tiled::tile_size, Tiled::order>(src, dst);
+    }
+
+    template <class Tiled>
+    void from_tiled(Tiled src, Span2d<std::remove_const_t<typename Tiled::element_type>> dst) noexcept
+    {
+        using T = std::remove_const_t<typename Tiled::element_type>;
+        convert<false, T, Tiled::tile_size, Tiled::order>(dst, TiledSpan2d<const T, Tiled::tile_size, Tiled::order>(src));
+    }
+
+    SANDY_TILED_SPAN_CONVERSIONS(, uint8_t, 8, TileOrder::RowMajor)
+    SANDY_TILED_SPAN_CONVERSIONS(, uint8_t, 8, TileOrder::Morton)
+    SANDY_TILED_SPAN_CONVERSIONS(, uint8_t, 16, TileOrder::RowMajor)
+    SANDY_TILED_SPAN_CONVERSIONS(, uint8_t, 16, TileOrder::Morton)
+    SANDY_TILED_SPAN_CONVERSIONS(, uint32_t, 8, TileOrder::RowMajor)
+    SANDY_TILED_SPAN_CONVERSIONS(, uint32_t, 8, TileOrder::Morton)
+    SANDY_TILED_SPAN_CONVERSIONS(, uint32_t, 16, TileOrder::RowMajor)
+    SANDY_TILED_SPAN_CONVERSIONS(, uint32_t, 16, TileOrder::Morton)
+    SANDY_TILED_SPAN_CONVERSIONS(, float, 8, TileOrder::RowMajor)
+    SANDY_TILED_SPAN_CONVERSIONS(, float, 8, TileOrder::Morton)
+    SANDY_TILED_SPAN_CONVERSIONS(, float, 16, TileOrder::RowMajor)
+    SANDY_TILED_SPAN_CONVERSIONS(, float, 16, TileOrder::Morton)
+}
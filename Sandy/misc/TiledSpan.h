@@ -0,0 +1,148 @@
+/// @file
+///	@brief   sandy::TiledSpan2d
+///	@author  (C) 2023 ttsuki
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <array>
+#include <type_traits>
+#include <stdexcept>
+
+#include "./Span.h"
+
+namespace sandy
+{
+    enum struct TileOrder
+    {
+        RowMajor, // rows of a tile are contiguous
+        Morton,   // Z-order within a tile: 2x2 blocks, then 4x4 blocks, ...
+    };
+
+    /// 2d view over tiled storage: Tile x Tile element tiles, each stored contiguously, tiles laid out row by row.
+    /// Any (x, y) neighbourhood of a tile shares its cache lines, so column walks, transposes and rotations stay in cache.
+    /// Mirrors Span2d (cell, row, slice); rows are proxies rather than contiguous Span1d.
+    template <class T, size_t Tile = 8, TileOrder Order = TileOrder::RowMajor>
+    struct TiledSpan2d
+    {
+        static_assert(Tile >= 2 && Tile <= 256 && (Tile & (Tile - 1)) == 0, "Tile must be a power of two");
+
+        using element_type = T;
+        using void_t = std::conditional_t<std::is_const_v<T>, const void, void>;
+        using byte_t = std::conditional_t<std::is_const_v<T>, const std::byte, std::byte>;
+
+        static constexpr size_t tile_size = Tile;
+        static constexpr size_t tile_bytes = Tile * Tile * sizeof(T);
+        static constexpr TileOrder order = Order;
+
+        void_t* pointer{};     // tile (0, 0) of the storage
+        size_t width{};
+        size_t height{};
+        size_t tile_pitch{};   // bytes between rows of tiles
+        size_t x0{};           // origin of this view within the storage
+        size_t y0{};
+
+        /// Packed tile pitch and storage size for width x height elements.
+        [[nodiscard]] static constexpr size_t pitch_for(size_t width) noexcept { return (width + Tile - 1) / Tile * tile_bytes; }
+        [[nodiscard]] static constexpr size_t bytes_for(size_t width, size_t height) noexcept { return pitch_for(width) * ((height + Tile - 1) / Tile); }
+
+        /// View over bytes_for(width, height) bytes of storage.
+        [[nodiscard]] static constexpr TiledSpan2d over(void_t* storage, size_t width, size_t height) noexcept
+        {
+            return TiledSpan2d{storage, width, height, pitch_for(width), 0, 0};
+        }
+
+        // element index within a tile.
+        [[nodiscard]] static constexpr size_t index(size_t ix, size_t iy) noexcept
+        {
+            if constexpr (Order == TileOrder::RowMajor) return iy * Tile + ix;
+            else return morton_x[ix] | morton_x[iy] << 1;
+        }
+
+        // morton_x[x]: bits of x spread to the even bit positions.
+        static constexpr std::array<uint16_t, Tile> morton_x = []
+        {
+            std::array<uint16_t, Tile> m{};
+            for (size_t x = 0; x < Tile; x++)
+                for (size_t b = 0; (size_t{1} << b) < Tile; b++)
+                    m[x] |= static_cast<uint16_t>((x >> b & 1) << (2 * b));
+            return m;
+        }();
+
+        [[nodiscard]] constexpr size_t size() const noexcept { return height; }
+        [[nodiscard]] constexpr bool empty() const noexcept { return size() == 0; }
+
+        /// Start of the tile holding storage coordinates (sx, sy), i.e. view coordinates (sx - x0, sy - y0).
+        [[nodiscard]] constexpr T* tile(size_t sx, size_t sy) const noexcept
+        {
+            return reinterpret_cast<T*>(reinterpret_cast<byte_t*>(pointer) + sy / Tile * tile_pitch + sx / Tile * tile_bytes);
+        }
+
+        [[nodiscard]] constexpr T& cell(size_t x, size_t y) const
+        {
+#ifdef _DEBUG
+            if (x >= this->width) throw std::out_of_range("x");
+            if (y >= this->height) throw std::out_of_range("y");
+#endif
+            const size_t sx = x0 + x;
+            const size_t sy = y0 + y;
+            return tile(sx, sy)[index(sx % Tile, sy % Tile)];
+        }
+
+        struct Row
+        {
+            TiledSpan2d span;
+            size_t y;
+
+            [[nodiscard]] constexpr size_t size() const noexcept { return span.width; }
+            [[nodiscard]] constexpr T& operator [](size_t x) const { return span.cell(x, y); }
+        };
+
+        [[nodiscard]] constexpr Row row(size_t y) const { return Row{*this, y}; }
+        [[nodiscard]] constexpr Row operator [](size_t index) const { return this->row(index); }
+
+        [[nodiscard]] constexpr TiledSpan2d slice(size_t x, size_t y, size_t w, size_t h) const
+        {
+#ifdef _DEBUG
+            if (x > this->width) throw std::out_of_range("x");
+            if (x + w > this->width) throw std::out_of_range("x + w");
+            if (y > this->height) throw std::out_of_range("y");
+            if (y + h > this->height) throw std::out_of_range("y + h");
+#endif
+            return TiledSpan2d{pointer, w, h, tile_pitch, x0 + x, y0 + y};
+        }
+
+        template <class U = T, std::enable_if_t<!std::is_const_v<U>, int> = 0>
+        [[nodiscard]] constexpr operator TiledSpan2d<const U, Tile, Order>() const noexcept
+        {
+            return TiledSpan2d<const U, Tile, Order>{pointer, width, height, tile_pitch, x0, y0};
+        }
+    };
+
+    /// Linear <-> tiled copies of the common extent. Whole tiles move as contiguous rows (RowMajor) or 2x2 blocks (Morton),
+    /// with AVX2 Morton shuffles for 4-byte elements; partial tiles at slice edges go element by element.
+    template <class Tiled>
+    void to_tiled(Span2d<const typename Tiled::element_type> src, Tiled dst) noexcept;
+
+    template <class Tiled>
+    void from_tiled(Tiled src, Span2d<std::remove_const_t<typename Tiled::element_type>> dst) noexcept;
+
+#define SANDY_TILED_SPAN_CONVERSIONS(prefix, T, Tile, Order) \
+    prefix template void to_tiled(Span2d<const T>, TiledSpan2d<T, Tile, Order>) noexcept; \
+    prefix template void from_tiled(TiledSpan2d<T, Tile, Order>, Span2d<T>) noexcept; \
+    prefix template void from_tiled(TiledSpan2d<const T, Tile, Order>, Span2d<T>) noexcept;
+
+    SANDY_TILED_SPAN_CONVERSIONS(extern, uint8_t, 8, TileOrder::RowMajor)
+    SANDY_TILED_SPAN_CONVERSIONS(extern, uint8_t, 8, TileOrder::Morton)
+    SANDY_TILED_SPAN_CONVERSIONS(extern, uint8_t, 16, TileOrder::RowMajor)
+    SANDY_TILED_SPAN_CONVERSIONS(extern, uint8_t, 16, TileOrder::Morton)
+    SANDY_TILED_SPAN_CONVERSIONS(extern, uint32_t, 8, TileOrder::RowMajor)
+    SANDY_TILED_SPAN_CONVERSIONS(extern, uint32_t, 8, TileOrder::Morton)
+    SANDY_TILED_SPAN_CONVERSIONS(extern, uint32_t, 16, TileOrder::RowMajor)
+    SANDY_TILED_SPAN_CONVERSIONS(extern, uint32_t, 16, TileOrder::Morton)
+    SANDY_TILED_SPAN_CONVERSIONS(extern, float, 8, TileOrder::RowMajor)
+    SANDY_TILED_SPAN_CONVERSIONS(extern, float, 8, TileOrder::Morton)
+    SANDY_TILED_SPAN_CONVERSIONS(extern, float, 16, TileOrder::RowMajor)
+    SANDY_TILED_SPAN_CONVERSIONS(extern, float, 16, TileOrder::Morton)
+}
@@ -0,0 +1,50 @@
+/// @file
+///	@brief   sandy::TransformHierarchy
+///	@author  (C) 2023 ttsuki
+
+#include "./TransformHierarchy.h"
+
+#include <algorithm>
+
+namespace sandy
+{
+    size_t TransformHierarchy::update() noexcept
+    {
+        const size_t count = parent_.size();
+        const size_t first = first_dirty_;
+        first_dirty_ = no_dirty;
+        updated_begin_ = updated_end_ = 0;
+        if (first >= count) return 0;
+
+        // Propagates dirty flags down: parents come first, so a parent's flag is final before its children read it.
+        uint8_t* dirty = dirty_.data();
+        const Index* parent = parent_.data();
+        for (size_t i = first; i < count; i++)
+            dirty[i] |= parent[i] != npos ? dirty[parent[i]] : uint8_t{0};
+
+        size_t updated = 0;
+        size_t last = first;
+        for (size_t i = std::find(dirty + first, dirty + count, uint8_t{1}) - dirty; i < count; i = std::find(dirty + i, dirty + count, uint8_t{1}) - dirty)
+        {
+            // run of dirty siblings: one batched multiply against the shared parent world.
+            const Index p = parent[i];
+            size_t end = i + 1;
+            while (end < count && dirty[end] && parent[end] == p) end++;
+
+            if (p == npos)
+                std::copy(local_.begin() + i, local_.begin() + end, world_.begin() + i);
+            else
+                multiply(&local_[i], world_[p], &world_[i], end - i);
+            transpose(&world_[i], &instance_[i], end - i);
+
+            if (updated == 0) updated_begin_ = i;
+            updated += end - i;
+            last = end;
+            i = end;
+        }
+
+        std::fill(dirty_.begin() + first, dirty_.begin() + last, uint8_t{0});
+        updated_end_ = last;
+        return updated;
+    }
+}
@@ -0,0 +1,106 @@
+/// @file
+///	@brief   sandy::TransformHierarchy
+///	@author  (C) 2023 ttsuki
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <limits>
+#include <stdexcept>
+
+#include "./Math.h"
+
+namespace sandy
+{
+    /// Flat transform hierarchy: nodes are stored parent-before-child, world = local * world(parent).
+    /// Only nodes whose local matrix (or an ancestor's) changed since the last update() are recomputed.
+    class TransformHierarchy final
+    {
+    public:
+        using Index = uint32_t;
+        static constexpr Index npos = ~Index{};
+
+    private:
+        static constexpr size_t no_dirty = std::numeric_limits<size_t>::max();
+
+        std::vector<Index> parent_{};
+        std::vector<Matrix4x4> local_{};
+        std::vector<Matrix4x4> world_{};
+        std::vector<Matrix4x4> instance_{}; // transpose(world_), WORLDMATRIX instance stream layout
+        std::vector<uint8_t> dirty_{};
+        size_t first_dirty_ = no_dirty;     // lowest dirty node; everything before it is clean
+        size_t updated_begin_{};
+        size_t updated_end_{};
+
+    public:
+        TransformHierarchy() = default;
+        TransformHierarchy(const TransformHierarchy& other) = default;
+        TransformHierarchy(TransformHierarchy&& other) noexcept = default;
+        TransformHierarchy& operator=(const TransformHierarchy& other) = default;
+        TransformHierarchy& operator=(TransformHierarchy&& other) noexcept = default;
+        ~TransformHierarchy() = default;
+
+        /// Appends a node; parent must be an existing node or npos (root).
+        Index add(Index parent, const Matrix4x4& local = matrix4x4::Identity())
+        {
+            if (parent != npos && parent >= parent_.size()) throw std::out_of_range("parent");
+            if (parent_.size() >= npos) throw std::length_error("too many nodes");
+
+            Index index = static_cast<Index>(parent_.size());
+            parent_.push_back(parent);
+            local_.push_back(local);
+            world_.emplace_back();
+            instance_.emplace_back();
+            dirty_.push_back(1);
+            first_dirty_ = std::min(first_dirty_, static_cast<size_t>(index));
+            return index;
+        }
+
+        void reserve(size_t count)
+        {
+            parent_.reserve(count);
+            local_.reserve(count);
+            world_.reserve(count);
+            instance_.reserve(count);
+            dirty_.reserve(count);
+        }
+
+        void clear() noexcept
+        {
+            parent_.clear();
+            local_.clear();
+            world_.clear();
+            instance_.clear();
+            dirty_.clear();
+            first_dirty_ = no_dirty;
+            updated_begin_ = updated_end_ = 0;
+        }
+
+        void set_local(Index node, const Matrix4x4& local) noexcept
+        {
+            local_[node] = local;
+            dirty_[node] = 1;
+            first_dirty_ = std::min(first_dirty_, static_cast<size_t>(node));
+        }
+
+        [[nodiscard]] size_t size() const noexcept { return parent_.size(); }
+        [[nodiscard]] Index parent(Index node) const noexcept { return parent_[node]; }
+        [[nodiscard]] const Matrix4x4& local(Index node) const noexcept { return local_[node]; }
+        [[nodiscard]] const Matrix4x4& world(Index node) const noexcept { return world_[node]; } // valid after update()
+
+        /// Recomputes dirty subtrees. Returns the number of recomputed nodes.
+        size_t update() noexcept;
+
+        /// World matrices of all nodes (row-vector), valid after update().
+        [[nodiscard]] const Matrix4x4* world_matrices() const noexcept { return world_.data(); }
+
+        /// transpose(world) of all nodes, i.e. the WORLDMATRIX instance stream layout, valid after update().
+        [[nodiscard]] const Matrix4x4* instance_matrices() const noexcept { return instance_.data(); }
+
+        /// Node range [begin, end) touched by the last update(), for partial uploads. Empty if nothing changed.
+        [[nodiscard]] size_t updated_begin() const noexcept { return updated_begin_; }
+        [[nodiscard]] size_t updated_end() const noexcept { return updated_end_; }
+    };
+}
@@ -0,0 +1,5 @@
+/// @file
+///	@brief   sandy::WorkStealingDeque
+///	@author  (C) 2023 ttsuki
+
+#include "./WorkStealingDeque.h"
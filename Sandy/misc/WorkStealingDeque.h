@@ -0,0 +1,126 @@
+/// @file
+///	@brief   sandy::WorkStealingDeque
+///	@author  (C) 2023 ttsuki
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <atomic>
+#include <memory>
+#include <optional>
+#include <vector>
+#include <type_traits>
+
+namespace sandy
+{
+    /// Chase-Lev work-stealing deque: the owner thread pushes and pops at the bottom without contention,
+    /// any other thread steals from the top. Only the last element makes the owner race a thief (one CAS).
+    /// Grows as needed; replaced rings are kept until destruction, since a thief may still be reading one.
+    /// T is copied in and out with relaxed atomics, so it must be trivially copyable, e.g. a pointer.
+    template <class T>
+    class WorkStealingDeque final
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "T must be trivially copyable");
+
+        static constexpr size_t cache_line = 64;
+
+        struct Ring
+        {
+            const int64_t mask;
+            std::unique_ptr<std::atomic<T>[]> slots;
+
+            explicit Ring(int64_t size) : mask(size - 1), slots(std::make_unique<std::atomic<T>[]>(static_cast<size_t>(size))) { }
+
+            [[nodiscard]] int64_t size() const noexcept { return mask + 1; }
+            [[nodiscard]] T get(int64_t i) const noexcept { return slots[static_cast<size_t>(i & mask)].load(std::memory_order_relaxed); }
+            void put(int64_t i, T value) noexcept { slots[static_cast<size_t>(i & mask)].store(value, std::memory_order_relaxed); }
+        };
+
+        alignas(cache_line) std::atomic<int64_t> top_{};    // thieves' end
+        alignas(cache_line) std::atomic<int64_t> bottom_{}; // owner's end
+        std::atomic<Ring*> ring_{};
+        std::vector<std::unique_ptr<Ring>> rings_{}; // owner only: the current ring and the ones it replaced
+
+        Ring* grow(Ring* ring, int64_t top, int64_t bottom)
+        {
+            auto bigger = std::make_unique<Ring>(ring->size() * 2);
+            for (int64_t i = top; i < bottom; i++)
+                bigger->put(i, ring->get(i));
+            ring = bigger.get();
+            rings_.push_back(std::move(bigger));
+            ring_.store(ring, std::memory_order_release);
+            return ring;
+        }
+
+    public:
+        /// capacity: initial ring size, rounded up to a power of two.
+        explicit WorkStealingDeque(size_t capacity = 64)
+        {
+            int64_t size = 2;
+            while (size < static_cast<int64_t>(capacity)) size <<= 1;
+            rings_.push_back(std::make_unique<Ring>(size));
+            ring_.store(rings_.back().get(), std::memory_order_relaxed);
+        }
+
+        WorkStealingDeque(const WorkStealingDeque& other) = delete;
+        WorkStealingDeque(WorkStealingDeque&& other) noexcept = delete;
+        WorkStealingDeque& operator=(const WorkStealingDeque& other) = delete;
+        WorkStealingDeque& operator=(WorkStealingDeque&& other) noexcept = delete;
+        ~WorkStealingDeque() = default;
+
+        /// Approximate unless called by the owner while no thief is active.
+        [[nodiscard]] bool empty() const noexcept
+        {
+            return bottom_.load(std::memory_order_acquire) <= top_.load(std::memory_order_acquire);
+        }
+
+        /// Owner: pushes value at the bottom.
+        void push(T value)
+        {
+            const int64_t bottom = bottom_.load(std::memory_order_relaxed);
+            const int64_t top = top_.load(std::memory_order_acquire);
+            Ring* ring = ring_.load(std::memory_order_relaxed);
+            if (bottom - top >= ring->size()) ring = grow(ring, top, bottom);
+            ring->put(bottom, value);
+            bottom_.store(bottom + 1, std::memory_order_release);
+        }
+
+        /// Owner: pops the most recently pushed value.
+        [[nodiscard]] std::optional<T> pop() noexcept
+        {
+            const int64_t bottom = bottom_.load(std::memory_order_relaxed) - 1;
+            Ring* ring = ring_.load(std::memory_order_relaxed);
+            bottom_.exchange(bottom, std::memory_order_seq_cst); // a thief either sees the claim or we see its top
+            int64_t top = top_.load(std::memory_order_seq_cst);
+
+            if (top > bottom) // empty
+            {
+                bottom_.store(bottom + 1, std::memory_order_relaxed);
+                return std::nullopt;
+            }
+
+            std::optional<T> value(ring->get(bottom));
+            if (top == bottom) // last one: race the thieves for it
+            {
+                if (!top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+                    value.reset();
+                bottom_.store(bottom + 1, std::memory_order_relaxed);
+            }
+            return value;
+        }
+
+        /// Any thread: takes the oldest value. Returns nullopt if empty or another thread won it.
+        [[nodiscard]] std::optional<T> steal() noexcept
+        {
+            int64_t top = top_.load(std::memory_order_seq_cst);
+            const int64_t bottom = bottom_.load(std::memory_order_seq_cst);
+            if (top >= bottom) return std::nullopt;
+
+            const T value = ring_.load(std::memory_order_acquire)->get(top);
+            if (!top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+                return std::nullopt;
+            return value;
+        }
+    };
+}
@@ -34,6 +34,16 @@
 #define ARKXMM_API  static ARKXMM_INLINE auto ARKXMM_VECTORCALL
 #define ARKXMM_DEFINE_EXTENSION(...) decltype(__VA_ARGS__) { return (__VA_ARGS__); }
 
+// F16C half <-> float conversion. Every AVX2 CPU has it; define ARKXMM_HAS_F16C=0 to force the SSE2 fallback.
+// The path is chosen at compile time only: there is no runtime CPU detection, so an F16C build needs an F16C CPU.
+#if !defined(ARKXMM_HAS_F16C)
+#if defined(__F16C__) || defined(__AVX2__)
+#define ARKXMM_HAS_F16C 1
+#else
+#define ARKXMM_HAS_F16C 0
+#endif
+#endif
+
 namespace arkana::xmm
 {
     using std::int8_t;
@@ -46,6 +56,7 @@ namespace arkana::xmm
     using std::uint64_t;
     using float32_t = float;
     using float64_t = double;
+    enum struct float16_t : uint16_t {}; // IEEE 754 binary16 bits, storage only
 
 #ifdef __SIZEOF_INT128__ // if compiler has __int128
     using xint128_t = unsigned __int128;
@@ -93,6 +104,7 @@ namespace arkana::xmm
     using vu8x16 = XMM<uint8_t>;
     using vi16x8 = XMM<int16_t>;
     using vu16x8 = XMM<uint16_t>;
+    using vf16x8 = XMM<float16_t>;
     using vi32x4 = XMM<int32_t>;
     using vu32x4 = XMM<uint32_t>;
     using vf32x4 = XMM<float32_t>;
@@ -141,6 +153,7 @@ namespace arkana::xmm
     using vu8x32 = YMM<uint8_t>;
     using vi16x16 = YMM<int16_t>;
     using vu16x16 = YMM<uint16_t>;
+    using vf16x16 = YMM<float16_t>;
     using vi32x8 = YMM<int32_t>;
     using vu32x8 = YMM<uint32_t>;
     using vf32x8 = YMM<float32_t>;
@@ -1059,6 +1072,61 @@ namespace arkana::xmm
     template <class To> ARKXMM_API convert_cast(vf64x4 f64x4) -> enable::if_<To, vi32x4> { return {_mm256_cvttpd_epi32(f64x4.v)}; } // AVX {a,b|c,d} -> {a,b,c,d}
     template <class To> ARKXMM_API convert_cast(vf64x4 f64x4) -> enable::if_<To, vf32x4> { return {_mm256_cvtpd_ps(f64x4.v)}; }     // AVX {a,b|c,d} -> {a,b,c,d}
 
+    // half precision: vf16x8/vf16x16 are storage types, convert to float for arithmetic.
+    // Rounds to nearest even and keeps inf/NaN. The SSE2 fallback goes through float math for denormals, so DAZ/FTZ flushes them.
+    namespace f16c_fallback
+    {
+        // {h0,h1,h2,h3} in the low 16 bits of 32-bit lanes -> float (F. Giesen, "half_to_float_fast")
+        ARKXMM_API half_to_float(__m128i h) -> __m128
+        {
+            const __m128i expmant = _mm_and_si128(h, _mm_set1_epi32(0x7FFF));
+            const __m128i sign = _mm_slli_epi32(_mm_xor_si128(h, expmant), 16);
+            const __m128 scaled = _mm_mul_ps(_mm_castsi128_ps(_mm_slli_epi32(expmant, 13)), _mm_castsi128_ps(_mm_set1_epi32((254 - 15) << 23))); // rebias exponent, normalizes denormals
+            const __m128i infnan = _mm_and_si128(_mm_cmpgt_epi32(expmant, _mm_set1_epi32(0x7BFF)), _mm_set1_epi32(255 << 23));
+            return _mm_or_ps(scaled, _mm_castsi128_ps(_mm_or_si128(sign, infnan)));
+        }
+
+        // float -> half sign-extended to 32-bit lanes, ready for packs_epi32 (F. Giesen, "float_to_half_fast3_rtne")
+        ARKXMM_API float_to_half(__m128 f) -> __m128i
+        {
+            const __m128 justsign = _mm_and_ps(f, _mm_castsi128_ps(_mm_set1_epi32(INT32_MIN)));
+            const __m128 absf = _mm_xor_ps(f, justsign);
+            const __m128i absi = _mm_castps_si128(absf);
+            const __m128i inf_or_nan = _mm_or_si128(_mm_and_si128(_mm_castps_si128(_mm_cmpunord_ps(absf, absf)), _mm_set1_epi32(0x200)), _mm_set1_epi32(0x7C00));
+            const __m128i is_regular = _mm_cmpgt_epi32(_mm_set1_epi32((127 + 16) << 23), absi);    // below 65520: finite half
+            const __m128i is_subnormal = _mm_cmpgt_epi32(_mm_set1_epi32((127 - 14) << 23), absi); // below 2^-14: denormal half
+
+            // denormal: let float addition round the mantissa off
+            const __m128i subnormal_magic = _mm_set1_epi32(((127 - 15) + (23 - 10) + 1) << 23);
+            const __m128i subnormal = _mm_sub_epi32(_mm_castps_si128(_mm_add_ps(absf, _mm_castsi128_ps(subnormal_magic))), subnormal_magic);
+
+            // normal: rebias exponent and round half to even on bit 13
+            const __m128i odd = _mm_srai_epi32(_mm_slli_epi32(absi, 31 - 13), 31);
+            const __m128i normal = _mm_srli_epi32(_mm_sub_epi32(_mm_add_epi32(absi, _mm_set1_epi32(0xFFF - ((127 - 15) << 23))), odd), 13);
+
+            const __m128i finite = _mm_or_si128(_mm_and_si128(is_subnormal, subnormal), _mm_andnot_si128(is_subnormal, normal));
+            const __m128i joined = _mm_or_si128(_mm_and_si128(is_regular, finite), _mm_andnot_si128(is_regular, inf_or_nan));
+            return _mm_or_si128(joined, _mm_srai_epi32(_mm_castps_si128(justsign), 16));
+        }
+    }
+
+#if ARKXMM_HAS_F16C
+    template <class To> ARKXMM_API convert_cast(vf16x8 f16x4) -> enable::if_<To, vf32x4> { return {_mm_cvtph_ps(f16x4.v)}; }                                                 // F16C {a,b,c,d,_,_,_,_} -> {a,b,c,d}
+    template <class To> ARKXMM_API convert_cast(vf16x8 f16x8) -> enable::if_<To, vf32x8> { return {_mm256_cvtph_ps(f16x8.v)}; }                                              // F16C {a,...,h} -> {a,b,c,d|e,f,g,h}
+    template <class To> ARKXMM_API convert_cast(vf32x4 f32x4) -> enable::if_<To, vf16x8> { return {_mm_cvtps_ph(f32x4.v, _MM_FROUND_TO_NEAREST_INT)}; }                      // F16C {a,b,c,d} -> {a,b,c,d,0,0,0,0}
+    template <class To> ARKXMM_API convert_cast(vf32x8 f32x8) -> enable::if_<To, vf16x8> { return {_mm256_cvtps_ph(f32x8.v, _MM_FROUND_TO_NEAREST_INT)}; }                   // F16C {a,b,c,d|e,f,g,h} -> {a,...,h}
+#else
+    template <class To> ARKXMM_API convert_cast(vf16x8 f16x4) -> enable::if_<To, vf32x4> { return {f16c_fallback::half_to_float(_mm_unpacklo_epi16(f16x4.v, _mm_setzero_si128()))}; } // SSE2
+    template <class To> ARKXMM_API convert_cast(vf16x8 f16x8) -> enable::if_<To, vf32x8> { return {_mm256_set_m128(f16c_fallback::half_to_float(_mm_unpackhi_epi16(f16x8.v, _mm_setzero_si128())), f16c_fallback::half_to_float(_mm_unpacklo_epi16(f16x8.v, _mm_setzero_si128())))}; } // AVX
+    template <class To> ARKXMM_API convert_cast(vf32x4 f32x4) -> enable::if_<To, vf16x8> { return {_mm_packs_epi32(f16c_fallback::float_to_half(f32x4.v), _mm_setzero_si128())}; } // SSE2
+    template <class To> ARKXMM_API convert_cast(vf32x8 f32x8) -> enable::if_<To, vf16x8> { return {_mm_packs_epi32(f16c_fallback::float_to_half(_mm256_castps256_ps128(f32x8.v)), f16c_fallback::float_to_half(_mm256_extractf128_ps(f32x8.v, 1)))}; } // AVX
+#endif
+
+    // vf16x16 <-> two vf32x8, one 128-bit half at a time
+    template <class To> ARKXMM_API convert_cast_lo(vf16x16 f16x16) -> enable::if_<To, vf32x8> { return convert_cast<vf32x8>(lower128(f16x16)); }                                // {a,...,h|_,...,_} -> {a,b,c,d|e,f,g,h}
+    template <class To> ARKXMM_API convert_cast_hi(vf16x16 f16x16) -> enable::if_<To, vf32x8> { return convert_cast<vf32x8>(higher128(f16x16)); }                               // {_,...,_|i,...,p} -> {i,j,k,l|m,n,o,p}
+    template <class To> ARKXMM_API convert_cast(vf32x8 lo, vf32x8 hi) -> enable::if_<To, vf16x16> { return from_values<vf16x16>(convert_cast<vf16x8>(lo), convert_cast<vf16x8>(hi)); } // {a,...,h}, {i,...,p} -> {a,...,h|i,...,p}
+
     // avx2 gather
     template <class XMM> ARKXMM_API gather(const typename XMM::element_t* table, vu32x4 idx) -> enable::if_32x4<XMM> { return {_mm_i32gather_epi32(reinterpret_cast<const int32_t*>(table), idx.v, 4)}; }    // returns 4 elements idx{i,j,k,l}->{xi,xj,xk,xl}
     template <class XMM> ARKXMM_API gather(const typename XMM::element_t* table, vu64x2 idx) -> enable::if_32x4<XMM> { return {_mm_i64gather_epi32(reinterpret_cast<const int32_t*>(table), idx.v, 4)}; }    // returns 2 elements idx{i,j} -> {xi,xj,0,0}
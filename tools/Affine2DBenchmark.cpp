@@ -0,0 +1,96 @@
+/// @file
+///	@brief   Affine2D benchmark: instance size and batch transform cost vs Matrix4x4
+///	@author  (C) 2023 ttsuki
+
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "../Sandy/misc/Math.h"
+#include "./Benchmark.h"
+
+using namespace sandy;
+
+namespace
+{
+    void run(size_t count, int inner)
+    {
+        std::mt19937 rng(4);
+        std::uniform_real_distribution<float> d(-3.0f, 3.0f), s(0.5f, 2.0f);
+        std::vector<Vec2> scales(count), translations(count), points(count), transformed(count);
+        std::vector<float> rolls(count);
+        std::vector<Affine2D> affine(count), affine_out(count);
+        std::vector<Matrix4x4> matrix(count), matrix_out(count);
+        std::vector<PositionVector> matrix_points(count);
+        for (size_t i = 0; i < count; i++)
+        {
+            scales[i] = Vec2(s(rng), s(rng));
+            rolls[i] = d(rng);
+            translations[i] = Vec2(d(rng) * 100, d(rng) * 100);
+            points[i] = Vec2(d(rng), d(rng));
+            affine[i] = affine2d::ScaleRollTranslate(scales[i], rolls[i], translations[i]);
+            matrix[i] = to_matrix4x4(affine[i]);
+        }
+        const Affine2D parent = affine2d::ScaleRollTranslate(Vec2(1.5f, 0.7f), 0.3f, Vec2(10, 20));
+        const Matrix4x4 parent_matrix = to_matrix4x4(parent);
+
+        std::printf("%zu instances, ns/instance, Affine2D vs Matrix4x4\n", count);
+        auto compare = [&](const char* name, double a, double m)
+        {
+            std::printf("  %-32s %9.2f ns %9.2f ns\n", name, a, m);
+        };
+
+        compare("ScaleRollTranslate",
+                tools::measure_ns(count, inner, [&]
+                {
+                    for (size_t i = 0; i < count; i++) affine_out[i] = affine2d::ScaleRollTranslate(scales[i], rolls[i], translations[i]);
+                    tools::touch(affine_out.data());
+                }),
+                tools::measure_ns(count, inner, [&]
+                {
+                    for (size_t i = 0; i < count; i++) matrix_out[i] = matrix4x4::ScaleRollTranslate(scales[i], rolls[i], translations[i]);
+                    tools::touch(matrix_out.data());
+                }));
+        compare("multiply[]",
+                tools::measure_ns(count, inner, [&]
+                {
+                    multiply(affine.data(), parent, affine_out.data(), count);
+                    tools::touch(affine_out.data());
+                }),
+                tools::measure_ns(count, inner, [&]
+                {
+                    multiply(matrix.data(), parent_matrix, matrix_out.data(), count);
+                    tools::touch(matrix_out.data());
+                }));
+        compare("inverse[] (vs inverse_affine[])",
+                tools::measure_ns(count, inner, [&]
+                {
+                    inverse(affine.data(), affine_out.data(), count);
+                    tools::touch(affine_out.data());
+                }),
+                tools::measure_ns(count, inner, [&]
+                {
+                    inverse_affine(matrix.data(), matrix_out.data(), count);
+                    tools::touch(matrix_out.data());
+                }));
+        compare("transform_points[]",
+                tools::measure_ns(count, inner, [&]
+                {
+                    transform_points(parent, points.data(), transformed.data(), count);
+                    tools::touch(transformed.data());
+                }),
+                tools::measure_ns(count, inner, [&]
+                {
+                    transform_points(parent_matrix, points.data(), matrix_points.data(), count);
+                    tools::touch(matrix_points.data());
+                }));
+    }
+}
+
+int main()
+{
+    std::printf("Affine2D, instance data %zu bytes vs Matrix4x4 %zu bytes\n", sizeof(Affine2D), sizeof(Matrix4x4));
+    run(1000, 100);  // in cache
+    run(100000, 3); // memory bound
+    return 0;
+}
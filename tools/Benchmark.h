@@ -0,0 +1,62 @@
+/// @file
+///	@brief   Timing helpers shared by the benchmarks in tools/
+///	@author  (C) 2023 ttsuki
+
+#pragma once
+
+#include <cstddef>
+#include <cstdio>
+#include <atomic>
+#include <chrono>
+#include <algorithm>
+#include <vector>
+
+namespace sandy::tools
+{
+    namespace detail
+    {
+        inline const void* volatile touched{};
+    }
+
+    /// Makes the memory behind p observable, so the stores a measured loop made to it are kept.
+    inline void touch(const void* p) noexcept
+    {
+        detail::touched = p;
+        std::atomic_signal_fence(std::memory_order_seq_cst);
+    }
+
+    /// Runs f() inner times per repetition and returns the best repetition in nanoseconds per item.
+    template <class F>
+    double measure_ns(size_t items, int inner, F&& f, int repetitions = 15)
+    {
+        double best = 1e300;
+        for (int r = 0; r < repetitions; r++)
+        {
+            const auto start = std::chrono::steady_clock::now();
+            for (int i = 0; i < inner; i++)
+            {
+                f();
+                std::atomic_signal_fence(std::memory_order_seq_cst);
+            }
+            const auto end = std::chrono::steady_clock::now();
+            best = std::min(best, std::chrono::duration<double, std::nano>(end - start).count() / static_cast<double>(items) / inner);
+        }
+        return best;
+    }
+
+    /// Prints "name  ns/item" in the layout all the benchmarks share.
+    inline void report(const char* name, double ns_per_item)
+    {
+        std::printf("  %-32s %9.2f ns\n", name, ns_per_item);
+    }
+
+    /// Latency percentile of samples (sorted in place), in the unit the samples were taken in.
+    template <class T>
+    T percentile(std::vector<T>& samples, double p)
+    {
+        if (samples.empty()) return T{};
+        const size_t k = std::min(samples.size() - 1, static_cast<size_t>(p * static_cast<double>(samples.size())));
+        std::nth_element(samples.begin(), samples.begin() + static_cast<ptrdiff_t>(k), samples.end());
+        return samples[k];
+    }
+}
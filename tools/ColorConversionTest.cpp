@@ -0,0 +1,134 @@
+/// @file
+///	@brief   Batch color conversions vs their scalar Color4 versions: every byte order, odd counts and tails, in-place calls
+///	@author  (C) 2023 ttsuki
+
+#include <cstdio>
+#include <cstdint>
+#include <cmath>
+#include <algorithm>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "../Sandy/misc/Math.h"
+
+using namespace sandy;
+
+namespace
+{
+    int failures = 0;
+
+    // counts around the 8-color body: empty, tail only, exact multiples and every tail length after them.
+    constexpr size_t counts[] = {0, 1, 3, 7, 8, 9, 15, 16, 17, 31, 33, 1001};
+    constexpr ColorByteOrder orders[] = {ColorByteOrder::Rgba, ColorByteOrder::Bgra, ColorByteOrder::Argb};
+    constexpr float tolerance = 1e-6f; // documented error of the polynomial pow
+
+    const char* name_of(ColorByteOrder order)
+    {
+        return order == ColorByteOrder::Rgba ? "Rgba" : order == ColorByteOrder::Bgra ? "Bgra" : "Argb";
+    }
+
+    void check(bool ok, const char* what, const char* detail, double max_error = 0)
+    {
+        std::printf("  %-24s %-8s max |error| %.2e: %s\n", what, detail, max_error, ok ? "ok" : "FAILED");
+        if (!ok) failures++;
+    }
+
+    bool same(const Color4& a, const Color4& b)
+    {
+        return a.r() == b.r() && a.g() == b.g() && a.b() == b.b() && a.a() == b.a();
+    }
+
+    // |a - b| per component, relative above 1 (unpremultiplied colors may exceed it).
+    double error(const Color4& a, const Color4& b)
+    {
+        double e = 0;
+        for (auto [x, y] : {std::pair{a.r(), b.r()}, std::pair{a.g(), b.g()}, std::pair{a.b(), b.b()}, std::pair{a.a(), b.a()}})
+            e = std::max(e, std::abs(static_cast<double>(x) - y) / std::max(1.0, std::abs(static_cast<double>(y))));
+        return e;
+    }
+
+    std::vector<Color4> random_colors(std::mt19937& rng, size_t count, float lo, float hi)
+    {
+        std::uniform_real_distribution<float> d(lo, hi);
+        std::vector<Color4> colors(count);
+        for (size_t i = 0; i < count; i++)
+        {
+            colors[i] = Color4{d(rng), d(rng), d(rng), d(rng)};
+            if (i % 13 == 5) colors[i] = colors[i].with_alpha(0.0f); // zero alpha for unpremultiply
+        }
+        return colors;
+    }
+
+    // Runs batch(src, dst, n) for every count, out of place and in place, against scalar(c) on each element.
+    // Writes past dst[n] fail too. Passes when every result is within tolerance (0: bit-exact).
+    template <class Batch, class Scalar>
+    void compare(const char* what, std::mt19937& rng, float lo, float hi, float tol, Batch&& batch, Scalar&& scalar)
+    {
+        const Color4 guard{-7.0f, -7.0f, -7.0f, -7.0f};
+        bool ok = true, in_place_ok = true;
+        double max_error = 0;
+        for (size_t n : counts)
+        {
+            const std::vector<Color4> src = random_colors(rng, n, lo, hi);
+            std::vector<Color4> dst(n + 1, guard);
+            batch(src.data(), dst.data(), n);
+            for (size_t i = 0; i < n; i++)
+            {
+                const double e = error(dst[i], scalar(src[i]));
+                max_error = std::max(max_error, e);
+                ok &= tol == 0 ? same(dst[i], scalar(src[i])) : e <= tol;
+            }
+            ok &= same(dst[n], guard);
+
+            std::vector<Color4> in_place = src;
+            in_place.push_back(guard);
+            batch(in_place.data(), in_place.data(), n);
+            for (size_t i = 0; i <= n; i++) in_place_ok &= same(in_place[i], dst[i]);
+        }
+        check(ok, what, "", max_error);
+        check(in_place_ok, what, "in place");
+    }
+}
+
+int main()
+{
+    std::printf("batch color conversions vs scalar, counts 0 to 1001\n");
+    std::mt19937 rng(12345);
+
+    for (ColorByteOrder order : orders)
+    {
+        bool pack_ok = true, unpack_ok = true;
+        for (size_t n : counts)
+        {
+            // pack: out-of-range components clamp, so test beyond [0, 1]; bytes must be bit-exact.
+            const std::vector<Color4> colors = random_colors(rng, n, -0.1f, 1.1f);
+            std::vector<uint32_t> packed(n + 1, 0xDEADBEEF);
+            pack_colors(colors.data(), packed.data(), n, order);
+            for (size_t i = 0; i < n; i++) pack_ok &= packed[i] == pack_color(colors[i], order);
+            pack_ok &= packed[n] == 0xDEADBEEF;
+
+            std::vector<uint32_t> values(n);
+            for (uint32_t& v : values) v = static_cast<uint32_t>(rng());
+            const Color4 guard{-7.0f, -7.0f, -7.0f, -7.0f};
+            std::vector<Color4> unpacked(n + 1, guard);
+            unpack_colors(values.data(), unpacked.data(), n, order);
+            for (size_t i = 0; i < n; i++) unpack_ok &= same(unpacked[i], unpack_color(values[i], order));
+            unpack_ok &= same(unpacked[n], guard);
+        }
+        check(pack_ok, "pack_colors", name_of(order));
+        check(unpack_ok, "unpack_colors", name_of(order));
+    }
+
+    compare("linear_to_srgb", rng, 0.0f, 1.0f, tolerance,
+            [](const Color4* s, Color4* d, size_t n) { linear_to_srgb(s, d, n); }, [](Color4 c) { return linear_to_srgb(c); });
+    compare("srgb_to_linear", rng, 0.0f, 1.0f, tolerance,
+            [](const Color4* s, Color4* d, size_t n) { srgb_to_linear(s, d, n); }, [](Color4 c) { return srgb_to_linear(c); });
+    compare("premultiply_alpha", rng, 0.0f, 1.0f, 0.0f,
+            [](const Color4* s, Color4* d, size_t n) { premultiply_alpha(s, d, n); }, [](Color4 c) { return premultiply_alpha(c); });
+    compare("unpremultiply_alpha", rng, 0.0f, 1.0f, tolerance,
+            [](const Color4* s, Color4* d, size_t n) { unpremultiply_alpha(s, d, n); }, [](Color4 c) { return unpremultiply_alpha(c); });
+
+    std::printf(failures ? "%d failed\n" : "all passed\n", failures);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,120 @@
+/// @file
+///	@brief   ImageOps benchmark: AVX2 row kernels vs per-pixel loops at 1920x1080, checked against the per-pixel results
+///	@author  (C) 2023 ttsuki
+
+#include <cstdio>
+#include <cstdint>
+#include <algorithm>
+#include <random>
+#include <utility>
+
+#include "../Sandy/misc/Image.h"
+#include "../Sandy/misc/ImageOps.h"
+#include "./Benchmark.h"
+
+using namespace sandy;
+
+namespace
+{
+    // the per-pixel formulas ImageOps.h documents, as a scalar loop would write them.
+    constexpr uint32_t div255(uint32_t x) noexcept
+    {
+        return (x * 2 + 255) / 510;
+    }
+
+    constexpr uint32_t blend_pixel(uint32_t s, uint32_t d) noexcept
+    {
+        const uint32_t ia = 255 - (s >> 24);
+        uint32_t r = 0;
+        for (int shift = 0; shift < 32; shift += 8)
+            r |= std::min<uint32_t>((s >> shift & 0xFF) + div255((d >> shift & 0xFF) * ia), 255) << shift;
+        return r;
+    }
+
+    constexpr uint32_t premultiply_pixel(uint32_t s) noexcept
+    {
+        const uint32_t a = s >> 24;
+        return a << 24 | div255((s >> 16 & 0xFF) * a) << 16 | div255((s >> 8 & 0xFF) * a) << 8 | div255((s & 0xFF) * a);
+    }
+
+    constexpr uint32_t swap_rb(uint32_t s) noexcept
+    {
+        return (s & 0xFF00FF00) | (s >> 16 & 0xFF) | (s & 0xFF) << 16;
+    }
+
+    template <class T, class F>
+    void for_each_pixel(Image2d<T>& image, F&& f)
+    {
+        for (size_t y = 0; y < image.height(); y++)
+        {
+            auto row = image[y];
+            for (size_t x = 0; x < image.width(); x++) f(row[x], x, y);
+        }
+    }
+}
+
+int main()
+{
+    constexpr size_t W = 1920, H = 1080;
+    std::mt19937 rng(5);
+
+    Image2d<uint32_t> src(W, H), dst(W, H), ref(W, H);
+    Image2d<uint8_t> alpha(W, H);
+    for_each_pixel(src, [&](uint32_t& p, size_t, size_t) { p = premultiply_pixel(static_cast<uint32_t>(rng())); });
+    for_each_pixel(dst, [&](uint32_t& p, size_t, size_t) { p = static_cast<uint32_t>(rng()); });
+    for_each_pixel(alpha, [&](uint8_t& p, size_t, size_t) { p = static_cast<uint8_t>(rng()); });
+
+    // the kernels give the per-pixel results, including row tails and odd widths.
+    size_t mismatches = 0;
+    for (size_t w : {size_t{1}, size_t{7}, size_t{8}, size_t{31}, size_t{33}, size_t{100}})
+    {
+        Image2d<uint32_t> s(w, 13), d(w, 13), e(w, 13);
+        Image2d<uint8_t> a(w, 13);
+        for_each_pixel(s, [&](uint32_t& p, size_t, size_t) { p = static_cast<uint32_t>(rng()); });
+        for_each_pixel(d, [&](uint32_t& p, size_t, size_t) { p = static_cast<uint32_t>(rng()); });
+
+        premultiply(std::as_const(s).view(), e.view());
+        for_each_pixel(e, [&](uint32_t& p, size_t x, size_t y) { mismatches += p != premultiply_pixel(s[y][x]); });
+        copy(std::as_const(e).view(), s.view());
+        copy(std::as_const(d).view(), e.view());
+        blend_over(std::as_const(s).view(), e.view());
+        for_each_pixel(e, [&](uint32_t& p, size_t x, size_t y) { mismatches += p != blend_pixel(s[y][x], d[y][x]); });
+        swizzle(std::as_const(d).view(), e.view(), 2, 1, 0, 3);
+        for_each_pixel(e, [&](uint32_t& p, size_t x, size_t y) { mismatches += p != swap_rb(d[y][x]); });
+        extract_alpha(std::as_const(d).view(), a.view());
+        for_each_pixel(a, [&](uint8_t& p, size_t x, size_t y) { mismatches += p != d[y][x] >> 24; });
+        expand_alpha(std::as_const(a).view(), e.view(), 0x123456);
+        for_each_pixel(e, [&](uint32_t& p, size_t x, size_t y) { mismatches += p != (uint32_t{a[y][x]} << 24 | 0x123456); });
+    }
+
+    std::printf("ImageOps, %zux%zu, ns/pixel, kernel vs per-pixel loop (%zu mismatches)\n", W, H, mismatches);
+    auto compare = [&](const char* name, auto&& kernel, auto&& loop)
+    {
+        const double k = tools::measure_ns(W * H, 1, kernel, 10);
+        const double l = tools::measure_ns(W * H, 1, loop, 10);
+        std::printf("  %-32s %9.3f ns %9.3f ns  x%.1f\n", name, k, l, l / k);
+    };
+
+    compare("fill",
+            [&] { fill(dst.view(), 0xFF00FF00u); },
+            [&] { for_each_pixel(ref, [](uint32_t& p, size_t, size_t) { p = 0xFF00FF00u; }); tools::touch(ref.data()); });
+    compare("copy",
+            [&] { copy(std::as_const(src).view(), dst.view()); },
+            [&] { for_each_pixel(ref, [&](uint32_t& p, size_t x, size_t y) { p = src[y][x]; }); tools::touch(ref.data()); });
+    compare("blend_over",
+            [&] { blend_over(std::as_const(src).view(), dst.view()); },
+            [&] { for_each_pixel(ref, [&](uint32_t& p, size_t x, size_t y) { p = blend_pixel(src[y][x], p); }); tools::touch(ref.data()); });
+    compare("premultiply",
+            [&] { premultiply(std::as_const(src).view(), dst.view()); },
+            [&] { for_each_pixel(ref, [&](uint32_t& p, size_t x, size_t y) { p = premultiply_pixel(src[y][x]); }); tools::touch(ref.data()); });
+    compare("expand_alpha A8",
+            [&] { expand_alpha(std::as_const(alpha).view(), dst.view()); },
+            [&] { for_each_pixel(ref, [&](uint32_t& p, size_t x, size_t y) { p = uint32_t{alpha[y][x]} << 24 | 0xFFFFFF; }); tools::touch(ref.data()); });
+    compare("extract_alpha",
+            [&] { extract_alpha(std::as_const(src).view(), alpha.view()); },
+            [&] { for_each_pixel(alpha, [&](uint8_t& p, size_t x, size_t y) { p = static_cast<uint8_t>(src[y][x] >> 24); }); tools::touch(alpha.data()); });
+    compare("swizzle (2, 1, 0, 3)",
+            [&] { swizzle(std::as_const(src).view(), dst.view(), 2, 1, 0, 3); },
+            [&] { for_each_pixel(ref, [&](uint32_t& p, size_t x, size_t y) { p = swap_rb(src[y][x]); }); tools::touch(ref.data()); });
+    return mismatches ? 1 : 0;
+}
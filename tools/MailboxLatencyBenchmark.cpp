@@ -0,0 +1,116 @@
+/// @file
+///	@brief   Mailbox vs SpscQueue frame hand-off: age of the frame a polling consumer gets, with the producer faster or slower than it
+///	@author  (C) 2023 ttsuki
+
+#include <cstdio>
+#include <cstdint>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <optional>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "../Sandy/misc/Mailbox.h"
+#include "../Sandy/misc/SpscQueue.h"
+#include "./Benchmark.h"
+
+using namespace sandy;
+
+namespace
+{
+    using clock = std::chrono::steady_clock;
+
+    struct Frame
+    {
+        clock::time_point decoded{};
+        uint64_t sequence{};
+    };
+
+    bool in_order = true;
+
+    // A producer publishes a frame every produce_us while the consumer polls every consume_us, 400 times, like a decoder
+    // feeding a render loop. Prints how old the frames the consumer got were.
+    template <class Produce, class Consume>
+    void run(const char* name, int produce_us, int consume_us, Produce&& produce, Consume&& consume)
+    {
+        std::atomic<bool> stop{};
+        std::thread producer([&]
+        {
+            uint64_t sequence = 0;
+            for (auto next = clock::now(); !stop.load(); std::this_thread::sleep_until(next))
+            {
+                produce(Frame{clock::now(), ++sequence});
+                next += std::chrono::microseconds(produce_us);
+            }
+        });
+
+        std::vector<double> ages;
+        uint64_t last = 0;
+        auto next = clock::now();
+        for (int i = 0; i < 400; i++)
+        {
+            next += std::chrono::microseconds(consume_us);
+            std::this_thread::sleep_until(next);
+            if (std::optional<Frame> frame = consume())
+            {
+                ages.push_back(std::chrono::duration<double, std::micro>(clock::now() - frame->decoded).count());
+                in_order &= frame->sequence > last;
+                last = frame->sequence;
+            }
+        }
+        stop = true;
+        producer.join();
+
+        double mean = 0;
+        for (double age : ages) mean += age;
+        mean /= static_cast<double>(std::max<size_t>(ages.size(), 1));
+        std::printf("  %-32s %5zu frames, age mean %7.0f us, p95 %7.0f us\n", name, ages.size(), mean, tools::percentile(ages, 0.95));
+    }
+}
+
+int main()
+{
+    std::printf("Mailbox vs SpscQueue(4) frame hand-off\n");
+    for (auto [produce_us, consume_us] : {std::pair{1000, 4000}, std::pair{4000, 1000}})
+    {
+        std::printf("producer every %d us, consumer every %d us\n", produce_us, consume_us);
+        {
+            SpscQueue<Frame> queue(4);
+            run("queue, one pop per poll", produce_us, consume_us, [&](Frame f) { queue.emplace(f); }, [&] { return queue.try_pop(); });
+            queue.close();
+            queue.drain();
+        }
+        {
+            SpscQueue<Frame> queue(4);
+            run("queue, pop to the newest", produce_us, consume_us, [&](Frame f) { queue.emplace(f); }, [&]
+            {
+                std::optional<Frame> newest;
+                while (auto f = queue.try_pop()) newest = f;
+                return newest;
+            });
+            queue.close();
+            queue.drain();
+        }
+        {
+            Mailbox<Frame> mailbox;
+            run("mailbox", produce_us, consume_us, [&](Frame f) { mailbox.publish(f); }, [&] { return mailbox.take(); });
+        }
+    }
+
+    Mailbox<Frame> mailbox;
+    const double ns = tools::measure_ns(1000000, 1, [&]
+    {
+        for (uint64_t i = 0; i < 1000000; i++)
+        {
+            mailbox.back().sequence = i;
+            mailbox.publish();
+            (void)mailbox.update();
+        }
+    }, 5);
+    tools::report("publish + update, one thread", ns);
+
+    std::printf("  frames %s\n", in_order ? "in order" : "OUT OF ORDER");
+    return in_order ? 0 : 1;
+}
@@ -0,0 +1,139 @@
+/// @file
+///	@brief   Matrix4x4 inverse benchmark: inverse, inverse_affine, inverse_orthonormal and their batch versions
+///	@author  (C) 2023 ttsuki
+
+#if defined(_WIN32) && __has_include(<DirectXMath.h>)
+#include <DirectXMath.h> // first, so Math.h gets its XMMATRIX constructor
+#define HAS_DIRECTX_MATH 1
+#else
+#define HAS_DIRECTX_MATH 0
+#endif
+
+#include <cstdio>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "../Sandy/misc/Math.h"
+#include "./Benchmark.h"
+
+using namespace sandy;
+
+namespace
+{
+    void to_array(const Matrix4x4& m, float out[16])
+    {
+        const arkxmm::vf32x4* rows = &m.m0;
+        for (int r = 0; r < 4; r++)
+        {
+            auto row = arkxmm::to_array(rows[r]);
+            for (int c = 0; c < 4; c++) out[r * 4 + c] = row[c];
+        }
+    }
+
+    // max |m * inv - I| in double precision.
+    double identity_error(const Matrix4x4& m, const Matrix4x4& inv)
+    {
+        float a[16], b[16];
+        to_array(m, a);
+        to_array(inv, b);
+        double error = 0;
+        for (int i = 0; i < 4; i++)
+            for (int j = 0; j < 4; j++)
+            {
+                double sum = 0;
+                for (int k = 0; k < 4; k++) sum += static_cast<double>(a[i * 4 + k]) * b[k * 4 + j];
+                error = std::max(error, std::abs(sum - (i == j ? 1.0 : 0.0)));
+            }
+        return error;
+    }
+
+    // scalar cofactor expansion, the baseline where DirectXMath is not available.
+    Matrix4x4 cofactor_inverse(const Matrix4x4& matrix)
+    {
+        float m[16], inv[16];
+        to_array(matrix, m);
+        inv[0] = m[5] * m[10] * m[15] - m[5] * m[11] * m[14] - m[9] * m[6] * m[15] + m[9] * m[7] * m[14] + m[13] * m[6] * m[11] - m[13] * m[7] * m[10];
+        inv[4] = -m[4] * m[10] * m[15] + m[4] * m[11] * m[14] + m[8] * m[6] * m[15] - m[8] * m[7] * m[14] - m[12] * m[6] * m[11] + m[12] * m[7] * m[10];
+        inv[8] = m[4] * m[9] * m[15] - m[4] * m[11] * m[13] - m[8] * m[5] * m[15] + m[8] * m[7] * m[13] + m[12] * m[5] * m[11] - m[12] * m[7] * m[9];
+        inv[12] = -m[4] * m[9] * m[14] + m[4] * m[10] * m[13] + m[8] * m[5] * m[14] - m[8] * m[6] * m[13] - m[12] * m[5] * m[10] + m[12] * m[6] * m[9];
+        inv[1] = -m[1] * m[10] * m[15] + m[1] * m[11] * m[14] + m[9] * m[2] * m[15] - m[9] * m[3] * m[14] - m[13] * m[2] * m[11] + m[13] * m[3] * m[10];
+        inv[5] = m[0] * m[10] * m[15] - m[0] * m[11] * m[14] - m[8] * m[2] * m[15] + m[8] * m[3] * m[14] + m[12] * m[2] * m[11] - m[12] * m[3] * m[10];
+        inv[9] = -m[0] * m[9] * m[15] + m[0] * m[11] * m[13] + m[8] * m[1] * m[15] - m[8] * m[3] * m[13] - m[12] * m[1] * m[11] + m[12] * m[3] * m[9];
+        inv[13] = m[0] * m[9] * m[14] - m[0] * m[10] * m[13] - m[8] * m[1] * m[14] + m[8] * m[2] * m[13] + m[12] * m[1] * m[10] - m[12] * m[2] * m[9];
+        inv[2] = m[1] * m[6] * m[15] - m[1] * m[7] * m[14] - m[5] * m[2] * m[15] + m[5] * m[3] * m[14] + m[13] * m[2] * m[7] - m[13] * m[3] * m[6];
+        inv[6] = -m[0] * m[6] * m[15] + m[0] * m[7] * m[14] + m[4] * m[2] * m[15] - m[4] * m[3] * m[14] - m[12] * m[2] * m[7] + m[12] * m[3] * m[6];
+        inv[10] = m[0] * m[5] * m[15] - m[0] * m[7] * m[13] - m[4] * m[1] * m[15] + m[4] * m[3] * m[13] + m[12] * m[1] * m[7] - m[12] * m[3] * m[5];
+        inv[14] = -m[0] * m[5] * m[14] + m[0] * m[6] * m[13] + m[4] * m[1] * m[14] - m[4] * m[2] * m[13] - m[12] * m[1] * m[6] + m[12] * m[2] * m[5];
+        inv[3] = -m[1] * m[6] * m[11] + m[1] * m[7] * m[10] + m[5] * m[2] * m[11] - m[5] * m[3] * m[10] - m[9] * m[2] * m[7] + m[9] * m[3] * m[6];
+        inv[7] = m[0] * m[6] * m[11] - m[0] * m[7] * m[10] - m[4] * m[2] * m[11] + m[4] * m[3] * m[10] + m[8] * m[2] * m[7] - m[8] * m[3] * m[6];
+        inv[11] = -m[0] * m[5] * m[11] + m[0] * m[7] * m[9] + m[4] * m[1] * m[11] - m[4] * m[3] * m[9] - m[8] * m[1] * m[7] + m[8] * m[3] * m[5];
+        inv[15] = m[0] * m[5] * m[10] - m[0] * m[6] * m[9] - m[4] * m[1] * m[10] + m[4] * m[2] * m[9] + m[8] * m[1] * m[6] - m[8] * m[2] * m[5];
+        const float rcp_det = 1.0f / (m[0] * inv[0] + m[1] * inv[4] + m[2] * inv[8] + m[3] * inv[12]);
+        for (float& x : inv) x *= rcp_det;
+        return Matrix4x4(inv);
+    }
+
+    Matrix4x4 baseline_inverse(const Matrix4x4& m)
+    {
+#if HAS_DIRECTX_MATH
+        return Matrix4x4(DirectX::XMMatrixInverse(nullptr, DirectX::XMMATRIX{m.m0.v, m.m1.v, m.m2.v, m.m3.v}));
+#else
+        return cofactor_inverse(m);
+#endif
+    }
+}
+
+int main()
+{
+    constexpr size_t count = 1000;
+    constexpr int inner = 200;
+
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> d(-2.0f, 2.0f);
+    std::vector<Matrix4x4> general(count), affine(count), orthonormal(count), out(count);
+    for (size_t i = 0; i < count; i++)
+    {
+        general[i] = Matrix4x4(d(rng), d(rng), d(rng), d(rng), d(rng), d(rng), d(rng), d(rng), d(rng), d(rng), d(rng), d(rng), d(rng), d(rng), d(rng), d(rng));
+        affine[i] = matrix4x4::ScaleYawPitchRollTranslate(Vec3(d(rng) + 3, d(rng) + 3, d(rng) + 3), Vec3(d(rng), d(rng), d(rng)), Vec3(d(rng), d(rng), d(rng)));
+        orthonormal[i] = matrix4x4::ScaleYawPitchRollTranslate(Vec3(1, 1, 1), Vec3(d(rng), d(rng), d(rng)), Vec3(d(rng) * 10, d(rng), d(rng)));
+    }
+
+    double e_baseline = 0, e_general = 0, e_affine = 0, e_orthonormal = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        e_baseline = std::max(e_baseline, identity_error(general[i], baseline_inverse(general[i])));
+        e_general = std::max(e_general, identity_error(general[i], inverse(general[i])));
+        e_affine = std::max(e_affine, identity_error(affine[i], inverse_affine(affine[i])));
+        e_orthonormal = std::max(e_orthonormal, identity_error(orthonormal[i], inverse_orthonormal(orthonormal[i])));
+    }
+
+    std::printf("Matrix4x4 inverse, %zu matrices in cache, ns/matrix (baseline: %s)\n", count, HAS_DIRECTX_MATH ? "XMMatrixInverse" : "scalar cofactor");
+    std::printf("  max |M * inverse(M) - I|: baseline %.2g, inverse %.2g, inverse_affine %.2g, inverse_orthonormal %.2g\n", e_baseline, e_general, e_affine, e_orthonormal);
+
+    auto single = [&](const std::vector<Matrix4x4>& src, auto f)
+    {
+        return tools::measure_ns(count, inner, [&]
+        {
+            for (size_t i = 0; i < count; i++) out[i] = f(src[i]);
+            tools::touch(out.data());
+        });
+    };
+    auto batch = [&](const std::vector<Matrix4x4>& src, void (*f)(const Matrix4x4[], Matrix4x4[], size_t) noexcept)
+    {
+        return tools::measure_ns(count, inner, [&]
+        {
+            f(src.data(), out.data(), count);
+            tools::touch(out.data());
+        });
+    };
+
+    tools::report("baseline", single(general, [](const Matrix4x4& m) { return baseline_inverse(m); }));
+    tools::report("inverse", single(general, [](const Matrix4x4& m) { return inverse(m); }));
+    tools::report("inverse[]", batch(general, inverse));
+    tools::report("inverse_affine", single(affine, [](const Matrix4x4& m) { return inverse_affine(m); }));
+    tools::report("inverse_affine[]", batch(affine, inverse_affine));
+    tools::report("inverse_orthonormal", single(orthonormal, [](const Matrix4x4& m) { return inverse_orthonormal(m); }));
+    tools::report("inverse_orthonormal[]", batch(orthonormal, inverse_orthonormal));
+    return 0;
+}
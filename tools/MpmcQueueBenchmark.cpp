@@ -0,0 +1,113 @@
+/// @file
+///	@brief   MpmcQueue vs ConcurrentQueue throughput with 1 to 32 producer and consumer threads, single-element and batch calls
+///	@author  (C) 2023 ttsuki
+
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iterator>
+#include <thread>
+#include <vector>
+
+#include "../Sandy/misc/ConcurrentQueue.h"
+#include "../Sandy/misc/MpmcQueue.h"
+
+using namespace sandy;
+
+namespace
+{
+    constexpr size_t capacity = 256;
+    constexpr size_t batch = 64;
+    size_t mismatches = 0;
+
+    // output iterator summing what is assigned to it.
+    struct Sum
+    {
+        uint64_t* sum;
+        Sum& operator *() noexcept { return *this; }
+        Sum& operator ++() noexcept { return *this; }
+        Sum& operator =(size_t v) noexcept { *sum += v; return *this; }
+    };
+
+    // ns/item for count items pushed by threads producers and popped by as many consumers.
+    // batched: producers emplace_range() runs of 64, consumers drain_into(); otherwise emplace() and pop_wait().
+    template <class Queue>
+    double run(size_t threads, size_t count, bool batched)
+    {
+        Queue queue(capacity);
+        std::atomic<uint64_t> total{};
+        std::atomic<size_t> producing{threads};
+
+        const auto start = std::chrono::steady_clock::now();
+        std::vector<std::thread> workers;
+        for (size_t p = 0; p < threads; p++)
+        {
+            workers.emplace_back([&, p]
+            {
+                const size_t first = count * p / threads, last = count * (p + 1) / threads;
+                if (batched)
+                {
+                    size_t values[batch];
+                    for (size_t i = first; i < last; i += batch)
+                    {
+                        const size_t n = std::min(batch, last - i);
+                        for (size_t k = 0; k < n; k++) values[k] = i + k;
+                        queue.emplace_range(values, values + n);
+                    }
+                }
+                else
+                {
+                    for (size_t i = first; i < last; i++) queue.emplace(i);
+                }
+                if (--producing == 0) queue.close();
+            });
+        }
+        for (size_t c = 0; c < threads; c++)
+        {
+            workers.emplace_back([&]
+            {
+                uint64_t sum = 0;
+                if (batched) queue.drain_into(Sum{&sum});
+                else while (auto v = queue.pop_wait()) sum += *v;
+                total += sum;
+            });
+        }
+        for (auto& w : workers) w.join();
+        const auto end = std::chrono::steady_clock::now();
+
+        if (total != uint64_t{count} * (count - 1) / 2) mismatches++;
+        return std::chrono::duration<double, std::nano>(end - start).count() / static_cast<double>(count);
+    }
+
+    template <class Queue>
+    double best_of(int repetitions, size_t threads, size_t count, bool batched)
+    {
+        double best = 1e300;
+        for (int r = 0; r < repetitions; r++) best = std::min(best, run<Queue>(threads, count, batched));
+        return best;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    const size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 400000;
+
+    std::printf("MpmcQueue vs ConcurrentQueue, capacity %zu, %zu items, ns/item (%u hardware threads)\n",
+                capacity, count, std::thread::hardware_concurrency());
+    std::printf("  %-8s %10s %10s %10s %10s %10s\n", "threads", "Mpmc", "Mpmc spin", "Conc", "Mpmc x64", "Conc x64");
+    for (size_t threads : {size_t{1}, size_t{2}, size_t{4}, size_t{8}, size_t{16}, size_t{32}})
+    {
+        std::printf("  %2zu + %-3zu %10.1f %10.1f %10.1f %10.1f %10.1f\n", threads, threads,
+                    best_of<MpmcQueue<size_t>>(3, threads, count, false),
+                    best_of<MpmcQueue<size_t, false>>(3, threads, count, false),
+                    best_of<ConcurrentQueue<size_t>>(3, threads, count, false),
+                    best_of<MpmcQueue<size_t>>(3, threads, count, true),
+                    best_of<ConcurrentQueue<size_t>>(3, threads, count, true));
+    }
+
+    std::printf("  %zu runs lost or duplicated items\n", mismatches);
+    return mismatches ? 1 : 0;
+}
@@ -0,0 +1,97 @@
+/// @file
+///	@brief   parallel_for / parallel_for_tiles checks: nesting from workers and from the waiting thread, tile coverage, exceptions
+///	@author  (C) 2023 ttsuki
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstdint>
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "../Sandy/misc/ParallelFor.h"
+#include "../Sandy/misc/TaskScheduler.h"
+
+using namespace sandy;
+
+namespace
+{
+    int failures = 0;
+
+    void check(bool ok, const char* what, size_t workers)
+    {
+        std::printf("  %-50s workers %zu: %s\n", what, workers, ok ? "ok" : "FAILED");
+        if (!ok) failures++;
+    }
+
+    // a hang is a failure too: report it and exit instead of blocking the run.
+    void start_watchdog(int seconds)
+    {
+        std::thread([seconds]
+        {
+            std::this_thread::sleep_for(std::chrono::seconds(seconds));
+            std::printf("  timed out after %d s: deadlock\n", seconds);
+            std::fflush(stdout);
+            std::_Exit(2);
+        }).detach();
+    }
+}
+
+int main()
+{
+    start_watchdog(60);
+    std::printf("parallel_for / parallel_for_tiles\n");
+
+    for (size_t workers : {size_t{0}, size_t{1}, size_t{3}})
+    {
+        TaskScheduler scheduler(workers);
+
+        // parallel_for from a task: tasks also execute on the waiting thread, whose nested waits must run tasks too.
+        std::atomic<size_t> calls{0};
+        for (int repeat = 0; repeat < 100; repeat++)
+            parallel_for(0, 16, [&](size_t)
+            {
+                parallel_for(0, 8, [&](size_t) { parallel_for(0, 2, [&](size_t) { ++calls; }, 1, scheduler); }, 1, scheduler);
+            }, 1, scheduler);
+        check(calls == size_t{100} * 16 * 8 * 2, "nested parallel_for", workers);
+
+        // nested parallel_for_tiles, each pixel exactly once.
+        std::vector<uint32_t> pixels(100 * 70);
+        Span2d<uint32_t> span{};
+        span.pointer = pixels.data();
+        span.width = 100;
+        span.height = 70;
+        span.width_pitch = 100 * sizeof(uint32_t);
+        parallel_for_tiles(span, [&](Span2d<uint32_t> tile)
+        {
+            parallel_for_tiles(tile, [](Span2d<uint32_t> inner)
+            {
+                for (size_t y = 0; y < inner.height; y++)
+                    for (size_t x = 0; x < inner.width; x++)
+                        inner.row(y)[x]++;
+            }, TileGrain{7, 5, 0}, scheduler);
+        }, TileGrain{32, 16, 0}, scheduler);
+        bool once = true;
+        for (uint32_t p : pixels) once &= p == 1;
+        check(once, "nested parallel_for_tiles covers each pixel once", workers);
+
+        // the first exception is rethrown, and the scheduler still works afterwards.
+        bool thrown = false;
+        try
+        {
+            parallel_for_tiles(span, [](Span2d<uint32_t>, size_t, size_t y) { if (y == 48) throw std::runtime_error("tile"); }, TileGrain{32, 16, 0}, scheduler);
+        }
+        catch (const std::runtime_error&)
+        {
+            thrown = true;
+        }
+        std::atomic<size_t> after{0};
+        parallel_for(0, 64, [&](size_t) { ++after; }, 1, scheduler);
+        check(thrown && after == 64, "exception rethrown, scheduler reusable", workers);
+    }
+
+    std::printf(failures ? "%d failed\n" : "all passed\n", failures);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,109 @@
+/// @file
+///	@brief   Quaternion benchmark: Euler vs quaternion world matrices, and slerp/nlerp, over 100k transforms
+///	@author  (C) 2023 ttsuki
+
+#include <cstdio>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "../Sandy/misc/Math.h"
+#include "./Benchmark.h"
+
+using namespace sandy;
+
+namespace
+{
+    float max_difference(const Matrix4x4& a, const Matrix4x4& b)
+    {
+        const arkxmm::vf32x4* ra = &a.m0;
+        const arkxmm::vf32x4* rb = &b.m0;
+        float d = 0;
+        for (int r = 0; r < 4; r++)
+        {
+            auto x = arkxmm::to_array(ra[r]);
+            auto y = arkxmm::to_array(rb[r]);
+            for (int c = 0; c < 4; c++) d = std::max(d, std::abs(x[c] - y[c]));
+        }
+        return d;
+    }
+
+    float max_difference(Quaternion a, Quaternion b)
+    {
+        auto x = arkxmm::to_array(a.v);
+        auto y = arkxmm::to_array(b.v);
+        float d = 0;
+        for (int c = 0; c < 4; c++) d = std::max(d, std::abs(x[c] - y[c]));
+        return d;
+    }
+}
+
+int main()
+{
+    constexpr size_t count = 100000;
+    constexpr int inner = 3;
+
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<float> angle(-3.0f, 3.0f), scale(0.5f, 2.0f), weight(0.0f, 1.0f);
+    std::vector<Vec3> scales(count), rotations(count), translations(count);
+    std::vector<Quaternion> from(count), to(count), lerped(count);
+    std::vector<float> t(count);
+    std::vector<Matrix4x4> by_euler(count), by_quaternion(count);
+    for (size_t i = 0; i < count; i++)
+    {
+        scales[i] = Vec3(scale(rng), scale(rng), scale(rng));
+        rotations[i] = Vec3(angle(rng), angle(rng), angle(rng));
+        translations[i] = Vec3(angle(rng), angle(rng), angle(rng));
+        from[i] = quaternion::RotationYawPitchRoll(rotations[i]);
+        to[i] = quaternion::RotationYawPitchRoll(Vec3(angle(rng), angle(rng), angle(rng)));
+        t[i] = weight(rng);
+    }
+
+    // the two paths build the same matrices.
+    float e_matrix = 0, e_slerp = 0, e_nlerp = 0;
+    scale_rotate_translate(scales.data(), from.data(), translations.data(), by_quaternion.data(), count);
+    slerp(from.data(), to.data(), t.data(), lerped.data(), count);
+    for (size_t i = 0; i < count; i++)
+    {
+        e_matrix = std::max(e_matrix, max_difference(matrix4x4::ScaleYawPitchRollTranslate(scales[i], rotations[i], translations[i]), by_quaternion[i]));
+        e_slerp = std::max(e_slerp, max_difference(slerp(from[i], to[i], t[i]), lerped[i]));
+    }
+    nlerp(from.data(), to.data(), t.data(), lerped.data(), count);
+    for (size_t i = 0; i < count; i++)
+        e_nlerp = std::max(e_nlerp, max_difference(nlerp(from[i], to[i], t[i]), lerped[i]));
+
+    std::printf("Quaternion, %zu transforms, ns/transform\n", count);
+    std::printf("  max |diff|: Euler vs quaternion matrix %.2g, batch vs scalar slerp %.2g, nlerp %.2g\n", e_matrix, e_slerp, e_nlerp);
+
+    tools::report("ScaleYawPitchRollTranslate", tools::measure_ns(count, inner, [&]
+    {
+        for (size_t i = 0; i < count; i++) by_euler[i] = matrix4x4::ScaleYawPitchRollTranslate(scales[i], rotations[i], translations[i]);
+        tools::touch(by_euler.data());
+    }));
+    tools::report("ScaleRotateTranslate", tools::measure_ns(count, inner, [&]
+    {
+        for (size_t i = 0; i < count; i++) by_quaternion[i] = matrix4x4::ScaleRotateTranslate(scales[i], from[i], translations[i]);
+        tools::touch(by_quaternion.data());
+    }));
+    tools::report("scale_rotate_translate[]", tools::measure_ns(count, inner, [&]
+    {
+        scale_rotate_translate(scales.data(), from.data(), translations.data(), by_quaternion.data(), count);
+        tools::touch(by_quaternion.data());
+    }));
+    tools::report("slerp", tools::measure_ns(count, inner, [&]
+    {
+        for (size_t i = 0; i < count; i++) lerped[i] = slerp(from[i], to[i], t[i]);
+        tools::touch(lerped.data());
+    }));
+    tools::report("slerp[]", tools::measure_ns(count, inner, [&]
+    {
+        slerp(from.data(), to.data(), t.data(), lerped.data(), count);
+        tools::touch(lerped.data());
+    }));
+    tools::report("nlerp[]", tools::measure_ns(count, inner, [&]
+    {
+        nlerp(from.data(), to.data(), t.data(), lerped.data(), count);
+        tools::touch(lerped.data());
+    }));
+    return 0;
+}
@@ -0,0 +1,310 @@
+/// @file
+///	@brief   Randomized stress test and throughput/latency benchmark of ConcurrentQueue, MpmcQueue and SpscQueue:
+///	         producers, consumers, capacity, close timing and pop calls vary per round; lost or duplicated items and deadlocks fail
+///	@author  (C) 2023 ttsuki
+
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <random>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+#include "../Sandy/misc/ConcurrentQueue.h"
+#include "../Sandy/misc/MpmcQueue.h"
+#include "../Sandy/misc/SpscQueue.h"
+#include "./Benchmark.h"
+
+using namespace sandy;
+
+namespace
+{
+    using clock = std::chrono::steady_clock;
+
+    struct Item
+    {
+        uint32_t producer;
+        uint32_t sequence;
+        clock::time_point pushed;
+    };
+
+    enum struct CloseMode
+    {
+        AfterProducers, // close() once every producer is done
+        Early,          // close() while producers are still pushing
+        Abandon,        // consumers quit and close() happens with items queued; the leftovers are drained afterwards
+    };
+
+    enum struct PopMode { Wait, WaitFor, Try, Mixed };
+
+    struct Scenario
+    {
+        size_t capacity;
+        int producers;
+        int consumers;
+        int items; // per producer
+        CloseMode close;
+        int close_after_us;
+        PopMode pop;
+        int timeout_us;
+        uint32_t seed;
+    };
+
+    struct Result
+    {
+        uint64_t popped{};
+        uint64_t lost{};       // accepted by emplace() but never popped
+        uint64_t duplicated{}; // popped twice, or popped without being accepted
+        uint64_t accepted_after_close{};
+        double seconds{};
+        std::vector<double> latencies_us{};
+    };
+
+    const char* name_of(CloseMode mode)
+    {
+        return mode == CloseMode::AfterProducers ? "after" : mode == CloseMode::Early ? "early" : "abandon";
+    }
+
+    template <class Queue>
+    Result run(Queue& queue, const Scenario& s)
+    {
+        std::atomic<bool> close_returned{};
+        std::atomic<bool> abandon{};
+        std::atomic<int> producers_done{};
+        std::atomic<uint64_t> accepted_after_close{};
+        std::vector<std::vector<uint8_t>> accepted(s.producers, std::vector<uint8_t>(s.items));
+        std::vector<std::vector<uint8_t>> seen(s.producers, std::vector<uint8_t>(s.items));
+        std::vector<std::vector<double>> latencies(s.consumers);
+
+        const auto start = clock::now();
+        std::vector<std::thread> threads;
+        for (int p = 0; p < s.producers; p++)
+        {
+            threads.emplace_back([&, p]
+            {
+                std::mt19937 rng(s.seed * 31 + p);
+                for (int i = 0; i < s.items; i++)
+                {
+                    const bool after_close = close_returned.load();
+                    if (!queue.emplace(Item{static_cast<uint32_t>(p), static_cast<uint32_t>(i), clock::now()})) break;
+                    accepted[p][i] = 1;
+                    if (after_close) ++accepted_after_close;
+                    if ((rng() & 1023) == 0) std::this_thread::yield();
+                }
+                ++producers_done;
+            });
+        }
+
+        // each item is written to seen[][] by the one consumer that popped it.
+        for (int c = 0; c < s.consumers; c++)
+        {
+            threads.emplace_back([&, c]
+            {
+                std::mt19937 rng(s.seed * 77 + c);
+                while (!abandon.load())
+                {
+                    const PopMode mode = s.pop == PopMode::Mixed ? static_cast<PopMode>(rng() % 3) : s.pop;
+                    std::optional<Item> item;
+                    if (mode == PopMode::Wait) item = queue.pop_wait();
+                    else if (mode == PopMode::WaitFor) item = queue.pop_wait_for(std::chrono::microseconds(1 + rng() % s.timeout_us));
+                    else if (!(item = queue.try_pop())) std::this_thread::yield();
+
+                    if (item)
+                    {
+                        seen[item->producer][item->sequence]++;
+                        latencies[c].push_back(std::chrono::duration<double, std::micro>(clock::now() - item->pushed).count());
+                    }
+                    else if (queue.closed())
+                    {
+                        return;
+                    }
+                }
+            });
+        }
+
+        std::thread closer([&]
+        {
+            if (s.close == CloseMode::AfterProducers)
+                while (producers_done.load() < s.producers) std::this_thread::sleep_for(std::chrono::microseconds(50));
+            else
+                std::this_thread::sleep_for(std::chrono::microseconds(s.close_after_us));
+            if (s.close == CloseMode::Abandon) abandon = true;
+            queue.close();
+            close_returned = true; // pushes that start after close() returned must all fail
+        });
+
+        // a hang is a failure too: report it and exit instead of blocking the run.
+        auto joined = std::async(std::launch::async, [&]
+        {
+            for (auto& t : threads) t.join();
+            closer.join();
+        });
+        if (joined.wait_for(std::chrono::seconds(10)) != std::future_status::ready)
+        {
+            std::printf("  DEADLOCK capacity %zu, %d producers, %d consumers, close %s\n", s.capacity, s.producers, s.consumers, name_of(s.close));
+            std::fflush(stdout);
+            std::_Exit(2);
+        }
+
+        Result r{};
+        r.seconds = std::chrono::duration<double>(clock::now() - start).count();
+        while (auto item = queue.try_pop()) seen[item->producer][item->sequence]++;
+        for (int p = 0; p < s.producers; p++)
+        {
+            for (int i = 0; i < s.items; i++)
+            {
+                if (accepted[p][i] && !seen[p][i]) r.lost++;
+                if (seen[p][i] > accepted[p][i]) r.duplicated += seen[p][i] - accepted[p][i];
+                if (seen[p][i]) r.popped++;
+            }
+        }
+        r.accepted_after_close = accepted_after_close;
+        for (auto& l : latencies) r.latencies_us.insert(r.latencies_us.end(), l.begin(), l.end());
+        return r;
+    }
+
+    // rounds of random scenarios; spsc keeps one producer and one consumer.
+    template <class Queue>
+    int stress(const char* name, int rounds, bool spsc, uint32_t seed)
+    {
+        std::mt19937 rng(seed);
+        int failures = 0;
+        uint64_t accepted_after_close = 0;
+        for (int round = 0; round < rounds; round++)
+        {
+            constexpr size_t capacities[] = {1, 2, 7, 64};
+            Scenario s{};
+            s.capacity = capacities[rng() % 4];
+            s.producers = spsc ? 1 : 1 + static_cast<int>(rng() % 4);
+            s.consumers = spsc ? 1 : 1 + static_cast<int>(rng() % 4);
+            s.items = 2000 + static_cast<int>(rng() % 3000);
+            s.close = static_cast<CloseMode>(rng() % 3);
+            s.close_after_us = static_cast<int>(rng() % 3000);
+            s.pop = static_cast<PopMode>(rng() % 4);
+            s.timeout_us = 1 + static_cast<int>(rng() % 500);
+            s.seed = static_cast<uint32_t>(rng());
+
+            Queue queue(s.capacity);
+            const Result r = run(queue, s);
+            accepted_after_close += r.accepted_after_close;
+            if (r.lost || r.duplicated || r.accepted_after_close)
+            {
+                failures++;
+                std::printf("  %s FAILED round %d: capacity %zu, %d producers, %d consumers, close %s: lost %llu, duplicated %llu, accepted after close %llu\n",
+                            name, round, s.capacity, s.producers, s.consumers, name_of(s.close),
+                            static_cast<unsigned long long>(r.lost), static_cast<unsigned long long>(r.duplicated),
+                            static_cast<unsigned long long>(r.accepted_after_close));
+            }
+        }
+        std::printf("  %-16s %d rounds, %d failed\n", name, rounds, failures);
+        std::fflush(stdout);
+        return failures;
+    }
+
+    // Weighted ConcurrentQueue, capacity 10 holding [5, 5]: a weight-9 producer blocks, then a weight-5 one. One pop makes room
+    // for the lighter producer only, which must get in instead of staying blocked behind the heavier one that still does not fit.
+    // range: the producers use emplace_range() and the pop is pop_many().
+    int weighted_wakeup(bool range)
+    {
+        ConcurrentQueue<int> queue(10, [](const int& weight) { return static_cast<size_t>(weight); });
+        queue.emplace(5);
+        queue.emplace(5);
+
+        std::atomic<bool> heavy_done{}, light_done{};
+        auto producer = [&](int weight, std::atomic<bool>& done)
+        {
+            return std::thread([&, weight]
+            {
+                const int values[] = {weight};
+                if (range) queue.emplace_range(std::begin(values), std::end(values));
+                else queue.emplace(weight);
+                done = true;
+            });
+        };
+        auto pop_one = [&]
+        {
+            int value{};
+            if (range) queue.pop_many(&value, 1);
+            else (void)queue.try_pop();
+        };
+
+        std::thread heavy = producer(9, heavy_done);
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        std::thread light = producer(5, light_done);
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+        pop_one();
+        for (auto deadline = clock::now() + std::chrono::seconds(2); !light_done.load() && clock::now() < deadline;)
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        const bool ok = light_done.load() && !heavy_done.load();
+
+        // let the heavy producer in as well, so both threads can be joined.
+        while (!heavy_done.load() || !light_done.load())
+        {
+            pop_one();
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        heavy.join();
+        light.join();
+
+        std::printf("  %-16s weighted wake-up, %s: %s\n", "ConcurrentQueue", range ? "emplace_range" : "emplace", ok ? "ok" : "FAILED, lighter producer stayed blocked");
+        std::fflush(stdout);
+        return ok ? 0 : 1;
+    }
+
+    template <class Queue>
+    void bench(const char* name, int producers, int consumers, size_t capacity)
+    {
+        const Scenario s{capacity, producers, consumers, 200000 / producers, CloseMode::AfterProducers, 0, PopMode::Wait, 1, 1};
+        Queue queue(capacity);
+        Result r = run(queue, s);
+        const double p50 = tools::percentile(r.latencies_us, 0.5);
+        const double p99 = tools::percentile(r.latencies_us, 0.99);
+        const double p999 = tools::percentile(r.latencies_us, 0.999);
+        std::printf("  %-16s %d+%d  %4zu  %7.2f Mops/s  p50 %8.1f  p99 %8.1f  p99.9 %9.1f us%s\n", name, producers, consumers, capacity,
+                    static_cast<double>(r.popped) / r.seconds / 1e6, p50, p99, p999, r.lost || r.duplicated ? "  FAILED" : "");
+        std::fflush(stdout);
+    }
+}
+
+/// QueueStressTest [seed [rounds [--no-bench]]]: rounds 0 runs the benchmark only.
+int main(int argc, char* argv[])
+{
+    const uint32_t seed = argc > 1 ? static_cast<uint32_t>(std::strtoul(argv[1], nullptr, 10)) : 12345;
+    const int rounds = argc > 2 ? std::atoi(argv[2]) : 60;
+    const bool benchmark = !(argc > 3 && std::strcmp(argv[3], "--no-bench") == 0);
+
+    int failures = 0;
+    if (rounds > 0)
+    {
+        std::printf("stress, seed %u\n", seed);
+        failures += stress<ConcurrentQueue<Item>>("ConcurrentQueue", rounds, false, seed);
+        failures += stress<MpmcQueue<Item>>("MpmcQueue", rounds, false, seed);
+        failures += stress<SpscQueue<Item>>("SpscQueue", rounds, true, seed);
+        failures += weighted_wakeup(false);
+        failures += weighted_wakeup(true);
+    }
+
+    if (benchmark)
+    {
+        std::printf("benchmark, pop_wait consumers, producers+consumers, capacity, push-to-pop latency\n");
+        for (auto [producers, consumers, capacity] : {std::tuple{1, 1, size_t{64}}, std::tuple{4, 4, size_t{64}}, std::tuple{4, 4, size_t{1024}}})
+        {
+            bench<ConcurrentQueue<Item>>("ConcurrentQueue", producers, consumers, capacity);
+            bench<MpmcQueue<Item>>("MpmcQueue", producers, consumers, capacity);
+            if (producers == 1 && consumers == 1) bench<SpscQueue<Item>>("SpscQueue", producers, consumers, capacity);
+        }
+    }
+
+    std::printf(failures ? "%d failed\n" : "all passed\n", failures);
+    return failures ? 1 : 0;
+}
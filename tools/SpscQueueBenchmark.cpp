@@ -0,0 +1,79 @@
+/// @file
+///	@brief   SpscQueue vs ConcurrentQueue: one producer and one consumer thread streaming 2M items, blocking and polling consumers
+///	@author  (C) 2023 ttsuki
+
+#include <cstdio>
+#include <cstdint>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+#include "../Sandy/misc/ConcurrentQueue.h"
+#include "../Sandy/misc/SpscQueue.h"
+
+using namespace sandy;
+
+namespace
+{
+    size_t mismatches = 0;
+
+    // ns/item for count items through a queue of the given capacity; the consumer blocks in pop_wait() or polls try_pop().
+    template <class Queue>
+    double stream(size_t count, size_t capacity, bool blocking)
+    {
+        Queue queue(capacity);
+        uint64_t sum = 0;
+
+        const auto start = std::chrono::steady_clock::now();
+        std::thread producer([&]
+        {
+            for (size_t i = 0; i < count; i++) queue.emplace(i);
+            queue.close();
+        });
+        if (blocking)
+        {
+            while (auto v = queue.pop_wait()) sum += *v;
+        }
+        else
+        {
+            while (!queue.closed())
+            {
+                if (auto v = queue.try_pop()) sum += *v;
+                else std::this_thread::yield();
+            }
+        }
+        producer.join();
+        const auto end = std::chrono::steady_clock::now();
+
+        if (sum != uint64_t{count} * (count - 1) / 2) mismatches++;
+        return std::chrono::duration<double, std::nano>(end - start).count() / static_cast<double>(count);
+    }
+
+    template <class Queue>
+    double best_of(int repetitions, size_t count, size_t capacity, bool blocking)
+    {
+        double best = 1e300;
+        for (int r = 0; r < repetitions; r++) best = std::min(best, stream<Queue>(count, capacity, blocking));
+        return best;
+    }
+}
+
+int main()
+{
+    constexpr size_t count = 2000000;
+
+    std::printf("SpscQueue vs ConcurrentQueue, 1 producer / 1 consumer, %zu items, ns/item (%u hardware threads)\n",
+                count, std::thread::hardware_concurrency());
+    std::printf("  %-10s %12s %12s %12s %12s\n", "capacity", "Spsc wait", "Conc wait", "Spsc poll", "Conc poll");
+    for (size_t capacity : {size_t{4}, size_t{64}, size_t{1024}})
+    {
+        std::printf("  %-10zu %12.1f %12.1f %12.1f %12.1f\n", capacity,
+                    best_of<SpscQueue<size_t>>(3, count, capacity, true),
+                    best_of<ConcurrentQueue<size_t>>(3, count, capacity, true),
+                    best_of<SpscQueue<size_t>>(3, count, capacity, false),
+                    best_of<ConcurrentQueue<size_t>>(3, count, capacity, false));
+    }
+
+    std::printf("  %zu runs lost or duplicated items\n", mismatches);
+    return mismatches ? 1 : 0;
+}
@@ -0,0 +1,116 @@
+/// @file
+///	@brief   Startup benchmark: process start-to-exit time of a program that uses the whole colors palette
+///	@author  (C) 2023 ttsuki
+
+#include <cstdio>
+#include <cstring>
+#include <chrono>
+#include <algorithm>
+#include <string>
+#include <iterator>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <Windows.h>
+#else
+#include <spawn.h>
+#include <sys/wait.h>
+extern char** environ;
+#endif
+
+#include "../Sandy/misc/Math.h"
+
+using namespace sandy;
+
+// compiles only while these stay constant expressions, i.e. need no dynamic initializer: a regression fails the build.
+static constexpr Color4 constant_color = colors::CornflowerBlue;
+static constexpr Color4 constant_rgb = Color4::from_rgb(0x6495ED);
+static constexpr Matrix4x4 constant_identity = matrix4x4::Identity();
+static constexpr Quaternion constant_rotation = quaternion::Identity();
+
+namespace
+{
+    // odr-uses every palette entry, so each one that needed a dynamic initializer would run it at startup.
+    constexpr const Color4* palette[] = {
+        &colors::Transparent, &colors::TransparentBlack, &colors::TransparentWhite, &colors::AliceBlue, &colors::AntiqueWhite,
+        &colors::Aqua, &colors::Aquamarine, &colors::Azure, &colors::Beige, &colors::Bisque, &colors::Black,
+        &colors::BlanchedAlmond, &colors::Blue, &colors::BlueViolet, &colors::Brown, &colors::BurlyWood, &colors::CadetBlue,
+        &colors::Chartreuse, &colors::Chocolate, &colors::Coral, &colors::CornflowerBlue, &colors::Cornsilk, &colors::Crimson,
+        &colors::Cyan, &colors::DarkBlue, &colors::DarkCyan, &colors::DarkGoldenRod, &colors::DarkGray, &colors::DarkGreen,
+        &colors::DarkKhaki, &colors::DarkMagenta, &colors::DarkOliveGreen, &colors::DarkOrange, &colors::DarkOrchid,
+        &colors::DarkRed, &colors::DarkSalmon, &colors::DarkSeaGreen, &colors::DarkSlateBlue, &colors::DarkSlateGray,
+        &colors::DarkTurquoise, &colors::DarkViolet, &colors::DeepPink, &colors::DeepSkyBlue, &colors::DimGray,
+        &colors::DodgerBlue, &colors::FireBrick, &colors::FloralWhite, &colors::ForestGreen, &colors::Fuchsia, &colors::Gainsboro,
+        &colors::GhostWhite, &colors::Gold, &colors::GoldenRod, &colors::Gray, &colors::Green, &colors::GreenYellow,
+        &colors::HoneyDew, &colors::HotPink, &colors::IndianRed, &colors::Indigo, &colors::Ivory, &colors::Khaki,
+        &colors::Lavender, &colors::LavenderBlush, &colors::LawnGreen, &colors::LemonChiffon, &colors::LightBlue,
+        &colors::LightCoral, &colors::LightCyan, &colors::LightGoldenRodYellow, &colors::LightGray, &colors::LightGreen,
+        &colors::LightPink, &colors::LightSalmon, &colors::LightSeaGreen, &colors::LightSkyBlue, &colors::LightSlateGray,
+        &colors::LightSteelBlue, &colors::LightYellow, &colors::Lime, &colors::LimeGreen, &colors::Linen, &colors::Magenta,
+        &colors::Maroon, &colors::MediumAquaMarine, &colors::MediumBlue, &colors::MediumOrchid, &colors::MediumPurple,
+        &colors::MediumSeaGreen, &colors::MediumSlateBlue, &colors::MediumSpringGreen, &colors::MediumTurquoise,
+        &colors::MediumVioletRed, &colors::MidnightBlue, &colors::MintCream, &colors::MistyRose, &colors::Moccasin,
+        &colors::NavajoWhite, &colors::Navy, &colors::OldLace, &colors::Olive, &colors::OliveDrab, &colors::Orange,
+        &colors::OrangeRed, &colors::Orchid, &colors::PaleGoldenRod, &colors::PaleGreen, &colors::PaleTurquoise,
+        &colors::PaleVioletRed, &colors::PapayaWhip, &colors::PeachPuff, &colors::Peru, &colors::Pink, &colors::Plum,
+        &colors::PowderBlue, &colors::Purple, &colors::RebeccaPurple, &colors::Red, &colors::RosyBrown, &colors::RoyalBlue,
+        &colors::SaddleBrown, &colors::Salmon, &colors::SandyBrown, &colors::SeaGreen, &colors::SeaShell, &colors::Sienna,
+        &colors::Silver, &colors::SkyBlue, &colors::SlateBlue, &colors::SlateGray, &colors::Snow, &colors::SpringGreen,
+        &colors::SteelBlue, &colors::Tan, &colors::Teal, &colors::Thistle, &colors::Tomato, &colors::Turquoise, &colors::Violet,
+        &colors::Wheat, &colors::White, &colors::WhiteSmoke, &colors::Yellow, &colors::YellowGreen
+    };
+
+    // one process start-to-exit, in microseconds.
+    double run_child(const char* self)
+    {
+        const auto start = std::chrono::steady_clock::now();
+#if defined(_WIN32)
+        std::string command = std::string("\"") + self + "\" --child";
+        STARTUPINFOA startup{};
+        startup.cb = sizeof(startup);
+        PROCESS_INFORMATION process{};
+        if (!CreateProcessA(self, command.data(), nullptr, nullptr, FALSE, 0, nullptr, nullptr, &startup, &process)) return 0;
+        WaitForSingleObject(process.hProcess, INFINITE);
+        CloseHandle(process.hThread);
+        CloseHandle(process.hProcess);
+#else
+        pid_t pid{};
+        char* argv[] = {const_cast<char*>(self), const_cast<char*>("--child"), nullptr};
+        if (posix_spawn(&pid, self, nullptr, nullptr, argv, environ) != 0) return 0;
+        int status{};
+        waitpid(pid, &status, 0);
+#endif
+        return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+    }
+}
+
+int main(int argc, char** argv)
+{
+    if (argc > 1 && std::strcmp(argv[1], "--child") == 0)
+    {
+        float sum = 0;
+        for (const Color4* color : palette) sum += color->r();
+        return sum > 0.0f ? 0 : 1;
+    }
+
+#if defined(_WIN32)
+    char self[MAX_PATH]{};
+    GetModuleFileNameA(nullptr, self, MAX_PATH);
+#else
+    const char* self = argv[0];
+#endif
+
+    constexpr int runs = 500;
+    double best = 1e300;
+    for (int i = 0; i < runs; i++) best = std::min(best, run_child(self));
+
+    std::printf("Startup, %zu palette colors odr-used, best of %d runs\n", std::size(palette), runs);
+    std::printf("  %-32s %9.1f us\n", "process start to exit", best);
+    (void)constant_color;
+    (void)constant_rgb;
+    (void)constant_identity;
+    (void)constant_rotation;
+    return 0;
+}
@@ -0,0 +1,90 @@
+/// @file
+///	@brief   TaskScheduler fine-grained overhead: empty tasks, one task per recursive call, parallel_for grain and parallel_for_tiles
+///	@author  (C) 2023 ttsuki
+
+#include <cstdio>
+#include <cstdint>
+#include <atomic>
+#include <chrono>
+#include <vector>
+
+#include "../Sandy/misc/ParallelFor.h"
+#include "../Sandy/misc/TaskScheduler.h"
+#include "./Benchmark.h"
+
+using namespace sandy;
+
+namespace
+{
+    long fib_serial(int n)
+    {
+        return n < 2 ? n : fib_serial(n - 1) + fib_serial(n - 2);
+    }
+
+    // one task per call: the worst case for spawn and steal overhead.
+    long fib_tasks(TaskScheduler& scheduler, int n)
+    {
+        if (n < 2) return n;
+        long a = 0;
+        TaskGroup group(scheduler);
+        group.run([&] { a = fib_tasks(scheduler, n - 1); });
+        const long b = fib_tasks(scheduler, n - 2);
+        group.wait();
+        return a + b;
+    }
+}
+
+int main()
+{
+    constexpr size_t tasks = 200000;
+    constexpr int fib_n = 25;
+    constexpr size_t indices = size_t{1} << 20;
+    const size_t calls = static_cast<size_t>(2 * fib_serial(fib_n + 1) - 1);
+
+    std::vector<float> values(indices, 1.0f);
+    auto step = [&](size_t i) { values[i] = values[i] * 1.0001f + 0.5f; };
+
+    Span2d<float> image{};
+    image.pointer = values.data();
+    image.width = 1024;
+    image.height = indices / 1024;
+    image.width_pitch = 1024 * sizeof(float);
+
+    bool correct = true;
+    for (size_t workers : {size_t{0}, size_t{1}, size_t{3}, size_t{7}})
+    {
+        TaskScheduler scheduler(workers);
+        std::printf("TaskScheduler, %zu workers (%u hardware threads), ns/item\n", workers, std::thread::hardware_concurrency());
+
+        tools::report("group.run + wait, empty tasks", tools::measure_ns(tasks, 1, [&]
+        {
+            std::atomic<size_t> count{};
+            TaskGroup group(scheduler);
+            for (size_t i = 0; i < tasks; i++) group.run([&] { count.fetch_add(1, std::memory_order_relaxed); });
+            group.wait();
+            correct &= count == tasks;
+        }, 5));
+
+        tools::report("fib(25), task per call", tools::measure_ns(calls, 1, [&] { correct &= fib_tasks(scheduler, fib_n) == fib_serial(fib_n); }, 3));
+        tools::report("fib(25), serial", tools::measure_ns(calls, 1, [&] { correct &= fib_serial(fib_n) != 0; }, 3));
+
+        tools::report("parallel_for 1M, grain 1", tools::measure_ns(indices, 1, [&] { parallel_for(0, indices, step, 1, scheduler); }, 3));
+        tools::report("parallel_for 1M, auto grain", tools::measure_ns(indices, 1, [&] { parallel_for(0, indices, step, 0, scheduler); }, 5));
+        tools::report("parallel_for_tiles 1M, 64K tiles", tools::measure_ns(indices, 1, [&]
+        {
+            parallel_for_tiles(image, [](Span2d<float> tile)
+            {
+                for (size_t y = 0; y < tile.height; y++)
+                    for (float& v : tile.row(y)) v = v * 1.0001f + 0.5f;
+            }, TileGrain{}, scheduler);
+        }, 5));
+        tools::report("serial loop 1M", tools::measure_ns(indices, 1, [&]
+        {
+            for (size_t i = 0; i < indices; i++) step(i);
+            tools::touch(values.data());
+        }, 5));
+    }
+
+    std::printf("  results %s\n", correct ? "ok" : "WRONG");
+    return correct ? 0 : 1;
+}
@@ -0,0 +1,119 @@
+/// @file
+///	@brief   TiledSpan2d benchmark: linear <-> tiled copies, column walks and 90 degree rotation, linear vs tiled storage
+///	@author  (C) 2023 ttsuki
+
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+
+#include "../Sandy/misc/Image.h"
+#include "../Sandy/misc/TiledSpan.h"
+#include "./Benchmark.h"
+
+using namespace sandy;
+
+namespace
+{
+    template <size_t Tile, TileOrder Order = TileOrder::RowMajor>
+    struct TiledImage
+    {
+        using Span = TiledSpan2d<uint32_t, Tile, Order>;
+        ImageBuffer buffer;
+        Span span;
+
+        TiledImage(size_t width, size_t height) : buffer(Span::bytes_for(width, height)), span(Span::over(buffer.data(), width, height)) { }
+    };
+
+    // dst(x, y) = src(y, n - 1 - x), whole Tile x Tile tiles at a time; both are row-major tiled n x n.
+    template <size_t Tile>
+    void rotate_tiles(TiledSpan2d<uint32_t, Tile> src, TiledSpan2d<uint32_t, Tile> dst, size_t n)
+    {
+        for (size_t ty = 0; ty < n; ty += Tile)
+            for (size_t tx = 0; tx < n; tx += Tile)
+            {
+                uint32_t* d = dst.tile(tx, ty);
+                const uint32_t* s = src.tile(ty, n - Tile - tx);
+                for (size_t iy = 0; iy < Tile; iy++)
+                    for (size_t ix = 0; ix < Tile; ix++)
+                        d[iy * Tile + ix] = s[(Tile - 1 - ix) * Tile + iy];
+            }
+    }
+}
+
+int main()
+{
+    constexpr size_t N = 4096;
+    constexpr size_t pixels = N * N;
+
+    Image2d<uint32_t> linear(N, N), result(N, N);
+    for (size_t y = 0; y < N; y++)
+        for (size_t x = 0; x < N; x++)
+            linear[y][x] = static_cast<uint32_t>(x * 7 + y);
+    const auto source = std::as_const(linear).view();
+
+    TiledImage<8> tiled8(N, N), rotated8(N, N);
+    TiledImage<8, TileOrder::Morton> morton8(N, N);
+    TiledImage<16> tiled16(N, N), rotated16(N, N);
+
+    std::printf("TiledSpan2d, %zux%zu uint32_t, ns/pixel\n", N, N);
+    tools::report("row memcpy (reference)", tools::measure_ns(pixels, 1, [&]
+    {
+        for (size_t y = 0; y < N; y++) std::memcpy(result[y].data(), linear[y].data(), N * sizeof(uint32_t));
+        tools::touch(result.data());
+    }, 5));
+    tools::report("to_tiled, 8 row-major", tools::measure_ns(pixels, 1, [&] { to_tiled(source, tiled8.span); }, 5));
+    tools::report("from_tiled, 8 row-major", tools::measure_ns(pixels, 1, [&] { from_tiled(tiled8.span, result.view()); }, 5));
+    tools::report("to_tiled, 8 Morton", tools::measure_ns(pixels, 1, [&] { to_tiled(source, morton8.span); }, 5));
+    tools::report("from_tiled, 8 Morton", tools::measure_ns(pixels, 1, [&] { from_tiled(morton8.span, result.view()); }, 5));
+    tools::report("to_tiled, 16 row-major", tools::measure_ns(pixels, 1, [&] { to_tiled(source, tiled16.span); }, 5));
+
+    // column-major walks: one cache line per element on linear storage, one per 8 elements of a tile row on tiled.
+    uint64_t sums[3]{};
+    tools::report("column sum, linear", tools::measure_ns(pixels, 1, [&]
+    {
+        uint64_t s = 0;
+        for (size_t x = 0; x < N; x++)
+            for (size_t y = 0; y < N; y++) s += linear[y][x];
+        sums[0] = s;
+    }, 3));
+    tools::report("column sum, 8 tiled by tile col", tools::measure_ns(pixels, 1, [&]
+    {
+        uint64_t s = 0;
+        for (size_t tx = 0; tx < N; tx += 8)
+            for (size_t y = 0; y < N; y++)
+            {
+                const uint32_t* row = tiled8.span.tile(tx, y) + y % 8 * 8;
+                for (size_t i = 0; i < 8; i++) s += row[i];
+            }
+        sums[1] = s;
+    }, 3));
+    tools::report("column sum, 8 tiled cell()", tools::measure_ns(pixels, 1, [&]
+    {
+        uint64_t s = 0;
+        for (size_t x = 0; x < N; x++)
+            for (size_t y = 0; y < N; y++) s += tiled8.span.cell(x, y);
+        sums[2] = s;
+    }, 3));
+
+    tools::report("rotate 90, linear", tools::measure_ns(pixels, 1, [&]
+    {
+        for (size_t y = 0; y < N; y++)
+            for (size_t x = 0; x < N; x++) result[y][x] = linear[N - 1 - x][y];
+        tools::touch(result.data());
+    }, 3));
+    tools::report("rotate 90, 8 tiled", tools::measure_ns(pixels, 1, [&] { rotate_tiles(tiled8.span, rotated8.span, N); tools::touch(rotated8.buffer.data()); }, 3));
+    tools::report("rotate 90, 16 tiled", tools::measure_ns(pixels, 1, [&] { rotate_tiles(tiled16.span, rotated16.span, N); tools::touch(rotated16.buffer.data()); }, 3));
+
+    // every layout holds the same pixels, and the rotations agree with the linear one.
+    size_t mismatches = (sums[0] != sums[1]) + (sums[0] != sums[2]);
+    from_tiled(morton8.span, result.view());
+    for (size_t y = 0; y < N; y += 7)
+        for (size_t x = 0; x < N; x += 3)
+            mismatches += result[y][x] != linear[y][x] || tiled16.span.cell(x, y) != linear[y][x];
+    for (size_t y = 0; y < N; y += 97)
+        for (size_t x = 0; x < N; x += 89)
+            mismatches += rotated8.span.cell(x, y) != linear[N - 1 - x][y] || rotated16.span.cell(x, y) != linear[N - 1 - x][y];
+    std::printf("  %zu mismatches\n", mismatches);
+    return mismatches ? 1 : 0;
+}
@@ -0,0 +1,97 @@
+/// @file
+///	@brief   TransformHierarchy benchmark: 100k nodes with 1% moving per frame, dirty update vs full recompute
+///	@author  (C) 2023 ttsuki
+
+#include <cstdio>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "../Sandy/misc/Math.h"
+#include "../Sandy/misc/TransformHierarchy.h"
+#include "./Benchmark.h"
+
+using namespace sandy;
+
+int main()
+{
+    constexpr size_t objects = 1000; // each a root, 9 children and 90 grandchildren
+    constexpr int frames = 30;
+
+    std::mt19937 rng(5);
+    std::uniform_real_distribution<float> d(-1.0f, 1.0f);
+    auto random_local = [&]
+    {
+        return matrix4x4::ScaleRotateTranslate(Vec3(1, 1, 1), quaternion::RotationYawPitchRoll(Vec3(d(rng), d(rng), d(rng))), Vec3(d(rng), d(rng), d(rng)));
+    };
+
+    TransformHierarchy hierarchy;
+    hierarchy.reserve(objects * 100);
+    for (size_t o = 0; o < objects; o++)
+    {
+        auto root = hierarchy.add(TransformHierarchy::npos, random_local());
+        for (int c = 0; c < 9; c++)
+        {
+            auto child = hierarchy.add(root, random_local());
+            for (int g = 0; g < 10; g++) hierarchy.add(child, random_local());
+        }
+    }
+    hierarchy.update();
+
+    const size_t count = hierarchy.size();
+    std::vector<TransformHierarchy::Index> moving(count / 100);
+    std::vector<Matrix4x4> poses(moving.size());
+    for (auto& node : moving) node = static_cast<TransformHierarchy::Index>(rng() % count);
+    for (auto& pose : poses) pose = random_local();
+
+    // what the scene graph did before: every node, every frame.
+    std::vector<Matrix4x4> world(count), instance(count);
+    auto full_recompute = [&]
+    {
+        for (size_t i = 0; i < count; i++)
+        {
+            const auto node = static_cast<TransformHierarchy::Index>(i);
+            const auto parent = hierarchy.parent(node);
+            world[i] = parent == TransformHierarchy::npos ? hierarchy.local(node) : hierarchy.local(node) * world[parent];
+            instance[i] = transpose(world[i]);
+        }
+        tools::touch(instance.data());
+    };
+
+    size_t recomputed = 0;
+    const double dirty = tools::measure_ns(1, 1, [&]
+    {
+        for (size_t k = 0; k < moving.size(); k++) hierarchy.set_local(moving[k], poses[k]);
+        recomputed = hierarchy.update();
+    }, frames);
+
+    const double full = tools::measure_ns(1, 1, full_recompute, frames);
+
+    const double all_dirty = tools::measure_ns(1, 1, [&]
+    {
+        for (size_t i = 0; i < count; i += 100) hierarchy.set_local(static_cast<TransformHierarchy::Index>(i), poses[0]);
+        hierarchy.update();
+    }, frames);
+
+    // the dirty update leaves the same matrices as a full recompute.
+    full_recompute();
+    float error = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        const arkxmm::vf32x4* a = &world[i].m0;
+        const arkxmm::vf32x4* b = &hierarchy.world_matrices()[i].m0;
+        for (int r = 0; r < 4; r++)
+        {
+            auto x = arkxmm::to_array(a[r]);
+            auto y = arkxmm::to_array(b[r]);
+            for (int c = 0; c < 4; c++) error = std::max(error, std::abs(x[c] - y[c]));
+        }
+    }
+
+    std::printf("TransformHierarchy, %zu nodes, %zu set_local per frame, us/frame\n", count, moving.size());
+    std::printf("  %zu nodes recomputed per frame, max |diff| vs full recompute %.2g\n", recomputed, error);
+    std::printf("  %-32s %9.1f us\n", "dirty update", dirty / 1e3);
+    std::printf("  %-32s %9.1f us\n", "full recompute", full / 1e3);
+    std::printf("  %-32s %9.1f us\n", "all nodes dirty", all_dirty / 1e3);
+    return 0;
+}